@@ -19,6 +19,9 @@
 #endif
 
 #include "Timer.h"
+#include "Random.h"
+#include "../../Part_1/greedy_class.cpp"
+#include "../tabu_class.cpp"
 #include <vector>
 #include <string>
 #include <stdio.h>
@@ -52,6 +55,25 @@ string inputFile = "../../../../input/instances/";
 // time limit for CPLEX (can be supplied to the algorithm via the -t comand line parameter)
 double time_limit = 3200.0;
 
+// number of threads used by CPLEX (-threads). With more than one thread
+// the times are wall-clock times, since CPU time adds up over the threads
+int n_threads = 1;
+Timer::TYPE clock_type = Timer::VIRTUAL;
+
+// pipeline mode (-pipeline 1): greedy followed by <tabu_iterations>
+// iterations of tabu search (-tabu), whose solution is given to CPLEX as a
+// MIP start
+bool pipeline = false;
+int64_t tabu_iterations = 20000;
+
+// lazy mode (-lazy 1): the model starts with the coverage constraints of
+// the <lazy_fraction> hardest nodes (-lazy_fraction); after every solve
+// the constraints violated by the solution are added, at most <lazy_batch>
+// per round (-lazy_batch)
+bool lazy = false;
+double lazy_fraction = 0.1;
+int lazy_batch = 10000;
+
 
 inline int stoi(string &s) {
 
@@ -79,12 +101,18 @@ void read_parameters(int argc, char **argv) {
         time_limit = atof(n.c_str());
     }
 
-    
-    /*while (iarg < argc) {
-        if (strcmp(argv[iarg],"-i")==0) inputFile = argv[++iarg];
-        else if (strcmp(argv[iarg],"-t")==0) time_limit = atof(argv[++iarg]);
+    // the options added to the model are read from the command line
+    int iarg = 1;
+    while (iarg < argc) {
+        if (strcmp(argv[iarg],"-threads") == 0) n_threads = max(1, atoi(argv[++iarg]));
+        else if (strcmp(argv[iarg],"-pipeline") == 0) pipeline = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-tabu") == 0) tabu_iterations = atoll(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-lazy") == 0) lazy = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-lazy_fraction") == 0) lazy_fraction = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-lazy_batch") == 0) lazy_batch = max(1, atoi(argv[++iarg]));
         iarg++;
-    }*/
+    }
+    if (n_threads > 1) clock_type = Timer::REAL;
 }
 
 ILOSOLVECALLBACK4(loggingCallback,
@@ -95,7 +123,7 @@ ILOSOLVECALLBACK4(loggingCallback,
                     
     if (hasIncumbent()) {
         IloNum nv = getIncumbentObjValue();
-        double newTime = timer.elapsed_time(Timer::VIRTUAL);
+        double newTime = timer.elapsed_time(clock_type);
         double newGap = 100.0*getMIPRelativeGap();
         if (result > double(nv)) {
             cout << "value " << nv << "\ttime " << newTime << "\tgap " << newGap << endl;
@@ -107,7 +135,31 @@ ILOSOLVECALLBACK4(loggingCallback,
 }
 
 
-void run_cplex(Timer& timer) {
+// Greedy solution improved by tabu search, used as the MIP start
+vector<int> run_heuristic(Timer& timer) {
+    vector< unordered_set<int> > nb(n_of_nodes);
+    for (int i = 0; i < n_of_nodes; ++i) nb[i].insert(neighbors[i].begin(), neighbors[i].end());
+    Graph graph = buildGraph(nb);
+    setNeighbor (nb);
+    unordered_set<int> greedySolution = greedy();
+    cout << "greedy " << greedySolution.size() << "\ttime " << timer.elapsed_time(clock_type) << endl;
+
+    time_t t;
+    Random* rnd = new Random((unsigned) time(&t));
+    rnd->next();
+    PIDSState state;
+    state.init(graph);
+    state.load(greedySolution);
+    int64_t tenure = 10 + graph.n/100;
+    TabuEngine tabu(state, rnd, tenure, tenure);
+    tabu.run(timer, numeric_limits<double>::max(), tabu_iterations);
+    delete rnd;
+    cout << "tabu search " << state.size() << "\ttime " << timer.elapsed_time(clock_type) << endl;
+    return state.members;
+}
+
+
+void run_cplex(Timer& timer, const vector<int>& start) {
 
     // variables for storing the result, the computation time, and
     // the optimality gap obtained by CPLEX for the provided input file
@@ -161,13 +213,29 @@ void run_cplex(Timer& timer) {
         // set the gap parameters to 0.0. This should always be done.
         cpl.setParam(IloCplex::EpGap, 0.0);
         cpl.setParam(IloCplex::EpAGap, 0.0);
-        // tell CPLEX to only use one single thread on your machine
-        cpl.setParam(IloCplex::Threads, 1);
+        // number of threads of the branch and bound
+        cpl.setParam(IloCplex::Threads, n_threads);
         // redirect all warnings to the null stream
         // in order to avoid printing them to the screen
         cpl.setWarning(env.getNullStream());
         cpl.use(loggingCallback(env, timer, time_stamp, result, gap));
 
+        // the heuristic solution is complete and feasible, so CPLEX only
+        // has to check it before taking it as the first incumbent
+        if (not start.empty()) {
+            IloNumVarArray startVar(env);
+            IloNumArray startVal(env);
+            vector<char> in(n_of_nodes, 0);
+            for (int i : start) in[i] = 1;
+            for (int i = 0; i < n_of_nodes; ++i) {
+                startVar.add(x[i]);
+                startVal.add(in[i]);
+            }
+            cpl.addMIPStart(startVar, startVal, IloCplex::MIPStartCheckFeas);
+            startVal.end();
+            startVar.end();
+        }
+
         // call solve() in order to start solving the problem
         cpl.solve();
     
@@ -179,7 +247,7 @@ void run_cplex(Timer& timer) {
         if (cpl.getStatus() == IloAlgorithm::Optimal or
             cpl.getStatus() == IloAlgorithm::Feasible)
         {
-            double newTime = timer.elapsed_time(Timer::VIRTUAL);
+            double newTime = timer.elapsed_time(clock_type);
             double lastVal = double(cpl.getObjValue());
             double lastGap = 100.0*cpl.getMIPRelativeGap();
             if (lastGap < 0.0) lastGap *= -1.0;
@@ -215,6 +283,161 @@ void run_cplex(Timer& timer) {
 }
 
 
+// Row generation: the constraints are only built for the nodes the
+// solutions actually violate. Every round solves the current model,
+// whose bound is a lower bound for the whole problem, and separates the
+// coverage constraints of the remaining nodes in one pass over the edges.
+// It ends when the solution of a round is feasible for all the nodes
+void run_cplex_lazy(Timer& timer, const vector<int>& start) {
+
+    IloEnv env;
+    env.setOut(env.getNullStream());
+    try{
+        IloModel model(env);
+        IloNumVarArray x(env, n_of_nodes, 0, 1, ILOINT);
+        IloExpr obj(env);
+        for (int i = 0; i < n_of_nodes; ++i) obj += x[i];
+        model.add(IloMinimize(env, obj));
+        obj.end();
+
+        // a node is harder the more of its neighbors it needs: nodes of
+        // degree one or two need all of them
+        vector<int> need(n_of_nodes);
+        vector<int> order(n_of_nodes);
+        for (int i = 0; i < n_of_nodes; ++i) {
+            need[i] = (neighbors[i].size() + 1)/2;
+            order[i] = i;
+        }
+        sort(order.begin(), order.end(), [&](int a, int b) {
+            long ra = long(need[a])*neighbors[b].size();
+            long rb = long(need[b])*neighbors[a].size();
+            if (ra != rb) return ra > rb;
+            return neighbors[a].size() < neighbors[b].size();
+        });
+
+        vector<char> inModel(n_of_nodes, 0);
+        int n_rows = 0;
+        auto addRow = [&](int i) {
+            IloExpr expr(env);
+            for (set<int>::iterator sit = neighbors[i].begin(); sit != neighbors[i].end(); ++sit) expr += x[*sit];
+            model.add(expr >= need[i]);
+            expr.end();
+            inModel[i] = 1;
+            n_rows++;
+        };
+        int initial = min(n_of_nodes, max(0, int(ceil(lazy_fraction*n_of_nodes))));
+        for (int k = 0; k < initial; ++k)
+            if (need[order[k]] > 0) addRow(order[k]);
+
+        IloCplex cpl(model);
+        cpl.setParam(IloCplex::EpGap, 0.0);
+        cpl.setParam(IloCplex::EpAGap, 0.0);
+        cpl.setParam(IloCplex::Threads, n_threads);
+        cpl.setWarning(env.getNullStream());
+
+        // the heuristic solution is feasible for every subset of the
+        // constraints; CPLEX keeps the start over the rounds
+        if (not start.empty()) {
+            IloNumVarArray startVar(env);
+            IloNumArray startVal(env);
+            vector<char> s(n_of_nodes, 0);
+            for (int i : start) s[i] = 1;
+            for (int i = 0; i < n_of_nodes; ++i) {
+                startVar.add(x[i]);
+                startVal.add(s[i]);
+            }
+            cpl.addMIPStart(startVar, startVal, IloCplex::MIPStartCheckFeas);
+            startVal.end();
+            startVar.end();
+        }
+
+        IloNumArray val(env, n_of_nodes);
+        vector<char> in(n_of_nodes, 0);
+        vector< pair<int,int> > violated;
+        bool feasible = false;
+        bool optimal = false;
+        double bound = 0.0;
+        for (int round = 1; ; ++round) {
+            double remaining = time_limit - timer.elapsed_time(clock_type);
+            if (remaining <= 0.0) break;
+            cpl.setParam(IloCplex::TiLim, remaining);
+            int solvedRows = n_rows;
+            double solveStart = timer.elapsed_time(clock_type);
+            cpl.solve();
+            double solveTime = timer.elapsed_time(clock_type) - solveStart;
+            if (cpl.getStatus() != IloAlgorithm::Optimal and
+                cpl.getStatus() != IloAlgorithm::Feasible) break;
+            if (cpl.getStatus() == IloAlgorithm::Optimal) bound = max(bound, double(cpl.getObjValue()));
+            else bound = max(bound, double(cpl.getBestObjValue()));
+
+            // separation: one pass over the edges
+            double sepStart = timer.elapsed_time(clock_type);
+            cpl.getValues(val, x);
+            for (int i = 0; i < n_of_nodes; ++i) in[i] = val[i] > 0.9;
+            violated.clear();
+            for (int i = 0; i < n_of_nodes; ++i) {
+                if (inModel[i]) continue;
+                int covered = 0;
+                for (set<int>::iterator sit = neighbors[i].begin(); sit != neighbors[i].end(); ++sit) covered += in[*sit];
+                if (covered < need[i]) violated.push_back(make_pair(need[i] - covered, i));
+            }
+            // the most violated constraints go first
+            int n_added = min(int(violated.size()), lazy_batch);
+            partial_sort(violated.begin(), violated.begin() + n_added, violated.end(),
+                         [](const pair<int,int>& a, const pair<int,int>& b) { return a.first > b.first; });
+            for (int k = 0; k < n_added; ++k) addRow(violated[k].second);
+            double sepTime = timer.elapsed_time(clock_type) - sepStart;
+
+            cout << "round " << round << "\tsolved rows " << solvedRows << "\tvalue " << cpl.getObjValue();
+            cout << "\tbound " << bound << "\tsolve time " << solveTime;
+            cout << "\tviolated " << violated.size() << "\tadded rows " << n_added;
+            cout << "\tseparation time " << sepTime << endl;
+            if (violated.empty()) {
+                feasible = true;
+                optimal = cpl.getStatus() == IloAlgorithm::Optimal;
+                break;
+            }
+        }
+
+        // out of time before the rows were complete: the heuristic
+        // solution, if any, is the best feasible one
+        if (not feasible and not start.empty()) {
+            in.assign(n_of_nodes, 0);
+            for (int i : start) in[i] = 1;
+            feasible = true;
+        }
+        if (feasible) {
+            double lastVal = 0.0;
+            for (int i = 0; i < n_of_nodes; ++i) lastVal += in[i];
+            double lastGap = optimal ? 0.0 : 100.0*(lastVal - bound)/lastVal;
+            cout << "value " << lastVal;
+            cout << "\ttime " << timer.elapsed_time(clock_type);
+            cout << "\tgap " << lastGap << endl;
+            if (optimal) cout << "optimality proven" << endl;
+            cout << "rows " << n_rows << " of " << n_of_nodes << endl;
+            cout << "nodes/vertices in the solution: (";
+            bool first = true;
+            for (int i = 0; i < n_of_nodes; ++i) {
+                if (in[i]) {
+                    if (first) {
+                        cout << i;
+                        first = false;
+                    }
+                    else cout << "," << i;
+                }
+            }
+            cout << ")" << endl;
+        }
+        else cout << "no feasible solution found" << endl;
+        val.end();
+    }
+    catch(IloException& e) {
+        cerr  << " ERROR: " << e << endl;
+    }
+    env.end();
+}
+
+
 // Main function
 
 int main( int argc, char **argv ) {
@@ -251,7 +474,10 @@ int main( int argc, char **argv ) {
         // Example for requesting the elapsed computation time at any moment:
         // double ct = timer.elapsed_time(Timer::VIRTUAL);
 
-        run_cplex(timer);
+        vector<int> start;
+        if (pipeline) start = run_heuristic(timer);
+        if (lazy) run_cplex_lazy(timer, start);
+        else run_cplex(timer, start);
         //--nipf;
     //}
     
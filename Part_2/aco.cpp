@@ -0,0 +1,344 @@
+/***************************************************************************
+    aco.cpp
+    (C) 2021 by C. Blum & M. Blesa
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Timer.h"
+#include "Random.h"
+#include "../Part_1/greedy_class.cpp"
+#include "pids_class.cpp"
+#include "thread_class.cpp"
+#include "bound_class.cpp"
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <fstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include <limits>
+#include <iomanip>
+
+// global variables concerning the random number generator (in case needed)
+time_t t;
+Random* rnd;
+
+// Data structures for the problem data
+int n_of_nodes;
+int n_of_arcs;
+vector< unordered_set<int> > neighbors;
+Graph graph;
+
+// string for keeping the name of the input file
+string inputFile;
+
+// computing time limit for each application of the metaheuristic
+double time_limit = 600.0;
+
+// number of applications of the metaheuristic
+int n_apps = 1;
+
+// ants per iteration and threads that build them
+int n_ants = 10;
+int n_threads = 1;
+
+// learning rate, determinism rate and weight of the deficit heuristic
+double rho = 0.1;
+double q0 = 0.5;
+double heuristic_weight = 2.0;
+
+// print the convergence statistics every <report> iterations
+int report = 100;
+
+// passes of the LP lower bound printed next to every result, 0 to skip it
+int lb_iterations = 500;
+
+
+void read_parameters(int argc, char **argv) {
+
+    int iarg = 1;
+    while (iarg < argc) {
+        if (strcmp(argv[iarg],"-i") == 0) inputFile = argv[++iarg];
+        // reading the computation time limit
+        // from the command line (if provided)
+        else if (strcmp(argv[iarg],"-t") == 0) time_limit = atoi(argv[++iarg]);
+        // reading the number of applications of the metaheuristic
+        // from the command line (if provided)
+        else if (strcmp(argv[iarg],"-n_apps") == 0) n_apps = atoi(argv[++iarg]);
+        // reading the parameters of the ant colony
+        else if (strcmp(argv[iarg],"-ants") == 0) n_ants = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-threads") == 0) n_threads = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-rho") == 0) rho = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-q0") == 0) q0 = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-beta") == 0) heuristic_weight = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-report") == 0) report = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-lb") == 0) lb_iterations = atoi(argv[++iarg]);
+        iarg++;
+    }
+    // a colony needs one ant at least
+    if (n_ants < 1) n_ants = 1;
+}
+
+
+//////////////////////////////////////////////////////////////
+//                      PHEROMONE                           //
+//////////////////////////////////////////////////////////////
+
+// Pheromone values in [tau_min, tau_max] (hyper-cube framework), stored
+// in a cache-line aligned array so the update loop is vectorized and
+// the ants only share read-only lines while they build
+const float tau_min = 0.001f;
+const float tau_max = 0.999f;
+
+struct Pheromone {
+    float* tau;
+    int n;
+
+    Pheromone(int size) : n(size) {
+        size_t bytes = (size_t(n)*sizeof(float) + 63)/64*64;
+        tau = static_cast<float*>(aligned_alloc(64, bytes > 0 ? bytes : 64));
+        reset();
+    }
+
+    ~Pheromone() { free(tau); }
+
+    void reset() {
+        for (int v = 0; v < n; v++) tau[v] = 0.5f;
+    }
+
+    // Move every value towards 1 for the members of the given solutions
+    // and towards 0 for the rest, weighting each solution by kappa
+    void update(const vector<char>& ib, const vector<char>& bs, float kappaIb, float kappaBs) {
+        float r = rho;
+        for (int v = 0; v < n; v++) {
+            float target = kappaIb*ib[v] + kappaBs*bs[v];
+            float value = tau[v] + r*(target - tau[v]);
+            tau[v] = value < tau_min ? tau_min : (value > tau_max ? tau_max : value);
+        }
+    }
+
+    // 0 while the values are spread, 1 once they sit on the bounds
+    double convergence() const {
+        double sum = 0.0;
+        for (int v = 0; v < n; v++) sum += max(tau_max - tau[v], tau[v] - tau_min);
+        return 2.0*(sum/(n*(tau_max - tau_min)) - 0.5);
+    }
+};
+
+
+//////////////////////////////////////////////////////////////
+//                        ANTS                              //
+//////////////////////////////////////////////////////////////
+
+// Build a PIDS: nodes are visited in random order, and while a node x is
+// under its threshold a non-member neighbor w is added, chosen from
+// tau[w] * eta[w]^heuristic_weight with eta[w] the deficient neighbors of w. Redundant
+// members are pruned at the end.
+void buildSolution(PIDSState& state, const Pheromone& ph, Random* r, vector<double>& prob) {
+    state.init(graph);
+    vector<int> order = r->generate_array(graph.n);
+    for (int x : order) {
+        while (state.popularity[x] < graph.need[x]) {
+            int deg = graph.degree(x);
+            const int* nb = graph.begin(x);
+            double total = 0.0;
+            int best = -1;
+            for (int k = 0; k < deg; k++) {
+                int w = nb[k];
+                prob[k] = 0.0;
+                if (state.in[w]) continue;
+                int eta = 0;
+                for (const int* y = graph.begin(w); y != graph.end(w); ++y)
+                    if (state.popularity[*y] < graph.need[*y]) eta++;
+                prob[k] = ph.tau[w]*pow(double(eta), heuristic_weight);
+                total += prob[k];
+                if (best < 0 or prob[k] > prob[best]) best = k;
+            }
+            int chosen = best;
+            if (r->next() >= q0 and total > 0.0) {
+                double p = r->next()*total;
+                for (int k = 0; k < deg; k++) {
+                    p -= prob[k];
+                    if (prob[k] > 0.0 and p <= 0.0) {
+                        chosen = k;
+                        break;
+                    }
+                }
+            }
+            state.add(nb[chosen]);
+        }
+    }
+    state.pruneAll();
+}
+
+
+/**********
+Main function
+**********/
+
+int main( int argc, char **argv ) {
+
+    read_parameters(argc,argv);
+
+    // setting the output format for doubles to 2 decimals after the comma
+    std::cout << std::setprecision(2) << std::fixed;
+
+    // initializing the random number generator. A random number
+    // between 0 and 1 is obtained with: double rnum = rnd->next();
+    rnd = new Random((unsigned) time(&t));
+    rnd->next();
+
+    // vectors for storing the result and the computation time
+    // obtained by the <n_apps> applications of the metaheuristic
+    vector<double> results(n_apps, std::numeric_limits<int>::max());
+    vector<double> times(n_apps, 0.0);
+
+    // opening the corresponding input file and reading the problem data
+    ifstream indata;
+    indata.open(inputFile.c_str());
+    if (not indata) { // file couldn't be opened
+        cout << "Error: file could not be opened" << endl;
+    }
+
+    indata >> n_of_nodes;
+    indata >> n_of_arcs;
+    neighbors = vector< unordered_set<int> >(n_of_nodes);
+    int u, v;
+    while (indata >> u >> v) {
+        neighbors[u - 1].insert(v - 1);
+        neighbors[v - 1].insert(u - 1);
+    }
+    indata.close();
+    graph = buildGraph(neighbors);
+
+    // certified lower bound from the LP relaxation
+    int lower_bound = lpLowerBound(graph, lb_iterations);
+
+    int maxDegree = 0;
+    for (int x = 0; x < graph.n; x++) maxDegree = max(maxDegree, graph.degree(x));
+
+    ThreadPool threads(n_threads);
+    // CPU time adds up over the threads, so use wall-clock time with several
+    Timer::TYPE clock = n_threads > 1 ? Timer::REAL : Timer::VIRTUAL;
+
+    // main loop over all applications of the metaheuristic
+    for (int na = 0; na < n_apps; ++na) {
+
+        // the computation time starts now
+        Timer timer;
+
+        cout << "start application " << na + 1 << endl;
+
+        // one state, generator and scratch array per ant
+        vector<PIDSState> ants(n_ants);
+        vector<Random> streams;
+        vector< vector<double> > prob(n_ants, vector<double>(maxDegree));
+        for (int a = 0; a < n_ants; a++) streams.push_back(Random(int(rnd->next()*2147483646) + 1));
+
+        Pheromone ph(graph.n);
+        vector<char> bestSolution(graph.n, 0);
+        vector<char> restartBest(graph.n, 0);
+        vector<char> iterationBest(graph.n, 0);
+        int bestSize = numeric_limits<int>::max();
+        int restartBestSize = numeric_limits<int>::max();
+        long iteration = 0;
+        double lastReport = timer.elapsed_time(clock);
+
+        while (timer.elapsed_time(clock) < time_limit) {
+            threads.run(n_ants, [&](int a) {
+                buildSolution(ants[a], ph, &streams[a], prob[a]);
+            });
+
+            int ib = 0;
+            for (int a = 1; a < n_ants; a++)
+                if (ants[a].size() < ants[ib].size()) ib = a;
+            iterationBest = ants[ib].in;
+            if (ants[ib].size() < restartBestSize) {
+                restartBestSize = ants[ib].size();
+                restartBest = ants[ib].in;
+            }
+            if (ants[ib].size() < bestSize) {
+                bestSize = ants[ib].size();
+                bestSolution = ants[ib].in;
+                results[na] = bestSize;
+                times[na] = timer.elapsed_time(clock);
+                cout << "value " << bestSize << "\ttime " << times[na] << endl;
+            }
+
+            // the weight moves from the iteration-best to the restart-best
+            // solution as the pheromone converges
+            double cf = ph.convergence();
+            float kappaIb = cf < 0.4 ? 1.0f : (cf < 0.6 ? 2.0f/3 : (cf < 0.8 ? 1.0f/3 : 0.0f));
+            ph.update(iterationBest, restartBest, kappaIb, 1.0f - kappaIb);
+            if (cf > 0.99) {
+                ph.reset();
+                restartBestSize = numeric_limits<int>::max();
+            }
+
+            iteration++;
+            if (report > 0 and iteration % report == 0) {
+                double now = timer.elapsed_time(clock);
+                cout << "value " << bestSize << "\ttime " << now << "\titeration " << iteration;
+                cout << "\tcf " << cf << "\tms/iteration " << 1000.0*(now - lastReport)/report << endl;
+                lastReport = now;
+            }
+        }
+
+        unordered_set<int> solution;
+        for (int x = 0; x < graph.n; x++)
+            if (bestSolution[x]) solution.insert(x);
+        setNeighbor (neighbors);
+        if (not check_PIDS(solution)) cout << "Error: solution is not a PIDS" << endl;
+
+        printGap(lower_bound, results[na]);
+        cout << "end application " << na + 1 << endl;
+    }
+
+    // calculating the average of the results and computation times,
+    // and their standard deviations, and write them to the screen
+    double r_mean = 0.0;
+    int r_best = std::numeric_limits<int>::max();
+    double t_mean = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        r_mean = r_mean + results[i];
+        if (int(results[i]) < r_best) r_best = int(results[i]);
+        t_mean = t_mean + times[i];
+    }
+    r_mean = r_mean/double(results.size());
+    t_mean = t_mean/double(times.size());
+    double rsd = 0.0;
+    double tsd = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        rsd = rsd + pow(results[i]-r_mean,2.0);
+        tsd = tsd + pow(times[i]-t_mean,2.0);
+    }
+    rsd = rsd/double(results.size());
+    if (rsd > 0.0) {
+        rsd = sqrt(rsd);
+    }
+    tsd = tsd/double(results.size());
+    if (tsd > 0.0) {
+        tsd = sqrt(tsd);
+    }
+    // printing statistical information
+    cout << r_best << "\t" << r_mean << "\t" << rsd << "\t";
+    cout << t_mean << "\t" << tsd << endl;
+}
@@ -0,0 +1,186 @@
+#ifndef BOUND_CLASS_CPP
+#define BOUND_CLASS_CPP
+
+#include "pids_class.cpp"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////
+//                       LP BOUND                           //
+//////////////////////////////////////////////////////////////
+
+// Lower bound from the LP relaxation min sum x, sum x[N(i)] >= need[i],
+// 0 <= x <= 1. Every y >= 0 gives the dual bound
+//     LB(y) = sum need[i] y[i] - sum max(0, load[v] - 1),
+// with load[v] = sum y[N(v)], so any y is a certificate. The bound is
+// raised by exact coordinate ascent: the best y[i] with the others
+// fixed is the need[i]-th smallest value at which a neighbor of i
+// reaches load 1. Every pass streams once over the adjacency.
+struct LPBound {
+    const Graph& g;
+    vector<double> y;
+    vector<double> load;
+    double value = 0.0;
+    long sweeps = 0;
+
+    // Start from y[i] = 1/max{deg(w) : w in N(i)}, where no load exceeds 1
+    LPBound(const Graph& graph) : g(graph), y(graph.n, 0.0), load(graph.n, 0.0) {
+        for (int i = 0; i < g.n; i++) {
+            int most = 0;
+            for (const int* w = g.begin(i); w != g.end(i); ++w) most = max(most, g.degree(*w));
+            if (g.need[i] > 0) y[i] = 1.0/most;
+        }
+        certify();
+    }
+
+    // One pass over all rows; returns the bound after it
+    double sweep() {
+        vector<double> t;
+        for (int i = 0; i < g.n; i++) {
+            int b = g.need[i];
+            if (b == 0) continue;
+            t.clear();
+            for (const int* v = g.begin(i); v != g.end(i); ++v) t.push_back(1.0 - load[*v] + y[i]);
+            nth_element(t.begin(), t.begin() + (b - 1), t.end());
+            double best = max(0.0, t[b - 1]);
+            double d = best - y[i];
+            if (d == 0.0) continue;
+            value += b*d;
+            for (const int* v = g.begin(i); v != g.end(i); ++v) {
+                value -= max(0.0, load[*v] + d - 1.0) - max(0.0, load[*v] - 1.0);
+                load[*v] += d;
+            }
+            y[i] = best;
+        }
+        sweeps++;
+        return value;
+    }
+
+    // Sweep until a pass gains less than tol or max_sweeps passes are done
+    double ascend(int max_sweeps, double tol = 1e-4) {
+        for (int k = 0; k < max_sweeps; k++) {
+            double before = value;
+            sweep();
+            if (value - before < tol) break;
+        }
+        return certify();
+    }
+
+    // Coordinate ascent stalls at kinks of LB, so it alternates with
+    // projected subgradient steps of Polyak size towards upper (an upper
+    // bound on the LP value, 5% above the bound if unknown). Ends at the
+    // best y seen
+    double run(int iterations, double upper = -1.0) {
+        ascend(20);
+        vector<double> bestY = y;
+        double best = value;
+        double mu = 0.5;
+        vector<double> grad(g.n);
+        evaluate(grad);
+        for (int it = 0; it < iterations; it++) {
+            double target = upper > 0.0 ? upper : 1.05*best + 1.0;
+            if (not step(grad, target, mu)) break;
+            evaluate(grad);
+            if (value > best) {
+                best = value;
+                bestY = y;
+            }
+            if (it % 50 == 49) mu *= 0.9;
+        }
+        y = bestY;
+        certify();
+        return ascend(20);
+    }
+
+    // LB(y) and a subgradient at y in a single pass over the adjacency:
+    // the load of v is gathered from its row and, if v is saturated (x[v]
+    // is 1 in the Lagrangian solution), scattered back over the same row.
+    // grad[i] = need[i] - saturated neighbors of i
+    double evaluate(vector<double>& grad) {
+        double lb = 0.0;
+        for (int i = 0; i < g.n; i++) grad[i] = g.need[i];
+        for (int v = 0; v < g.n; v++) {
+            const int* first = g.begin(v);
+            const int* last = g.end(v);
+            double l = 0.0;
+            for (const int* i = first; i != last; ++i) l += y[*i];
+            load[v] = l;
+            lb += g.need[v]*y[v] - max(0.0, l - 1.0);
+            if (l > 1.0 - 1e-9)
+                for (const int* i = first; i != last; ++i) grad[*i] -= 1.0;
+        }
+        value = lb;
+        return lb;
+    }
+
+    // Projected subgradient step of size mu (target - LB)/|grad|^2. Returns
+    // false, leaving y as it is, if the projected subgradient is zero
+    bool step(vector<double>& grad, double target, double mu) {
+        double norm = 0.0;
+        for (int i = 0; i < g.n; i++) {
+            if (y[i] <= 0.0 and grad[i] < 0.0) grad[i] = 0.0;
+            norm += grad[i]*grad[i];
+        }
+        if (norm == 0.0) return false;
+        double t = mu*(target - value)/norm;
+        for (int i = 0; i < g.n; i++) y[i] = max(0.0, y[i] + t*grad[i]);
+        return true;
+    }
+
+    // LB(y) recomputed from scratch, so rounding in the updates cannot leak in
+    double certify() {
+        double lb = 0.0;
+        for (int v = 0; v < g.n; v++) {
+            double l = 0.0;
+            for (const int* i = g.begin(v); i != g.end(v); ++i) l += y[*i];
+            load[v] = l;
+        }
+        for (int i = 0; i < g.n; i++) lb += g.need[i]*y[i] - max(0.0, load[i] - 1.0);
+        value = lb;
+        return lb;
+    }
+
+    // Integer bound on the size of any PIDS
+    int integerBound() const { return int(ceil(value - 1e-6)); }
+
+    // Reduced cost of x[v]: every PIDS S has |S| >= LB + sum over v of
+    // rc[v] if v is in S and rc[v] > 0, -rc[v] if v is not and rc[v] < 0
+    double reducedCost(int v) const { return 1.0 - load[v]; }
+
+    // Fix the nodes whose reduced cost rules out one value in every PIDS
+    // smaller than upper: fixed[v] is 0 or 1 then, -1 for the free nodes
+    int fixByReducedCost(int upper, vector<int>& fixed) const {
+        fixed.assign(g.n, -1);
+        int count = 0;
+        // no smaller PIDS exists at all: upper is optimal
+        if (integerBound() >= upper) return 0;
+        for (int v = 0; v < g.n; v++) {
+            double rc = reducedCost(v);
+            if (value + fabs(rc) > upper - 1 + 1e-6) {
+                fixed[v] = rc > 0.0 ? 0 : 1;
+                count++;
+            }
+        }
+        return count;
+    }
+};
+
+// Certified lower bound after the given passes of LPBound, 0 for none
+int lpLowerBound(const Graph& g, int iterations) {
+    if (iterations <= 0) return 0;
+    LPBound lp(g);
+    lp.run(iterations);
+    return lp.integerBound();
+}
+
+// Line with the lower bound and the gap of value to it, if there is a bound
+void printGap(int lower_bound, double value) {
+    if (lower_bound > 0)
+        cout << "lower bound " << lower_bound << "\tgap " << 100.0*(value - lower_bound)/value << endl;
+}
+
+#endif
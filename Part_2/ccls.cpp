@@ -0,0 +1,194 @@
+/***************************************************************************
+    ccls.cpp
+    (C) 2021 by C. Blum & M. Blesa
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Timer.h"
+#include "Random.h"
+#include "../Part_1/greedy_class.cpp"
+#include "pids_class.cpp"
+#include "ccls_class.cpp"
+#include "bound_class.cpp"
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <fstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include <limits>
+#include <iomanip>
+
+// global variables concerning the random number generator (in case needed)
+time_t t;
+Random* rnd;
+
+// Data structures for the problem data
+int n_of_nodes;
+int n_of_arcs;
+vector< unordered_set<int> > neighbors;
+Graph graph;
+
+// string for keeping the name of the input file
+string inputFile;
+
+// computing time limit for each application of the metaheuristic
+double time_limit = 600.0;
+
+// number of applications of the metaheuristic
+int n_apps = 1;
+
+// the weights are scaled by <rho> when their average passes <avg_limit>
+// (0 for NuMVC's n/2)
+double avg_limit = 0.0;
+double rho = 0.3;
+
+// passes of the LP lower bound printed next to every result, 0 to skip it
+int lb_iterations = 500;
+
+
+void read_parameters(int argc, char **argv) {
+
+    int iarg = 1;
+    while (iarg < argc) {
+        if (strcmp(argv[iarg],"-i") == 0) inputFile = argv[++iarg];
+        // reading the computation time limit
+        // from the command line (if provided)
+        else if (strcmp(argv[iarg],"-t") == 0) time_limit = atoi(argv[++iarg]);
+        // reading the number of applications of the metaheuristic
+        // from the command line (if provided)
+        else if (strcmp(argv[iarg],"-n_apps") == 0) n_apps = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-avg") == 0) avg_limit = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-rho") == 0) rho = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-lb") == 0) lb_iterations = atoi(argv[++iarg]);
+        iarg++;
+    }
+}
+
+/**********
+Main function
+**********/
+
+int main( int argc, char **argv ) {
+
+    read_parameters(argc,argv);
+
+    // setting the output format for doubles to 2 decimals after the comma
+    std::cout << std::setprecision(2) << std::fixed;
+
+    // initializing the random number generator. A random number
+    // between 0 and 1 is obtained with: double rnum = rnd->next();
+    rnd = new Random((unsigned) time(&t));
+    rnd->next();
+
+    // vectors for storing the result and the computation time
+    // obtained by the <n_apps> applications of the metaheuristic
+    vector<double> results(n_apps, std::numeric_limits<int>::max());
+    vector<double> times(n_apps, 0.0);
+
+    // opening the corresponding input file and reading the problem data
+    ifstream indata;
+    indata.open(inputFile.c_str());
+    if (not indata) { // file couldn't be opened
+        cout << "Error: file could not be opened" << endl;
+    }
+
+    indata >> n_of_nodes;
+    indata >> n_of_arcs;
+    neighbors = vector< unordered_set<int> >(n_of_nodes);
+    int u, v;
+    while (indata >> u >> v) {
+        neighbors[u - 1].insert(v - 1);
+        neighbors[v - 1].insert(u - 1);
+    }
+    indata.close();
+    graph = buildGraph(neighbors);
+
+    // certified lower bound from the LP relaxation
+    int lower_bound = lpLowerBound(graph, lb_iterations);
+
+    setNeighbor (neighbors);
+    unordered_set<int> greedySolution = greedy();
+    vector<int> start(greedySolution.begin(), greedySolution.end());
+
+    // main loop over all applications of the metaheuristic
+    for (int na = 0; na < n_apps; ++na) {
+
+        // the computation time starts now
+        Timer timer;
+
+        cout << "start application " << na + 1 << endl;
+
+        cout << "greedy " << start.size() << endl;
+
+        CCLocalSearch search(graph, rnd);
+        if (avg_limit > 0.0) search.avgLimit = avg_limit;
+        search.rho = rho;
+        search.load(start);
+        results[na] = start.size();
+        times[na] = timer.elapsed_time(Timer::VIRTUAL);
+        search.onImprove = [&](int k) {
+            results[na] = k;
+            times[na] = timer.elapsed_time(Timer::VIRTUAL);
+            cout << "value " << k << "\ttime " << times[na] << endl;
+        };
+        search.run(timer, Timer::VIRTUAL, time_limit);
+
+        double ct = timer.elapsed_time(Timer::VIRTUAL);
+        cout << "steps " << search.it << "\tper second " << search.it/ct << endl;
+
+        unordered_set<int> solution(search.best.begin(), search.best.end());
+        if (not check_PIDS(solution)) cout << "Error: solution is not a PIDS" << endl;
+
+        printGap(lower_bound, results[na]);
+        cout << "end application " << na + 1 << endl;
+    }
+
+    // calculating the average of the results and computation times,
+    // and their standard deviations, and write them to the screen
+    double r_mean = 0.0;
+    int r_best = std::numeric_limits<int>::max();
+    double t_mean = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        r_mean = r_mean + results[i];
+        if (int(results[i]) < r_best) r_best = int(results[i]);
+        t_mean = t_mean + times[i];
+    }
+    r_mean = r_mean/double(results.size());
+    t_mean = t_mean/double(times.size());
+    double rsd = 0.0;
+    double tsd = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        rsd = rsd + pow(results[i]-r_mean,2.0);
+        tsd = tsd + pow(times[i]-t_mean,2.0);
+    }
+    rsd = rsd/double(results.size());
+    if (rsd > 0.0) {
+        rsd = sqrt(rsd);
+    }
+    tsd = tsd/double(results.size());
+    if (tsd > 0.0) {
+        tsd = sqrt(tsd);
+    }
+    // printing statistical information
+    cout << r_best << "\t" << r_mean << "\t" << rsd << "\t";
+    cout << t_mean << "\t" << tsd << endl;
+}
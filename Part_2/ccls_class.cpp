@@ -0,0 +1,263 @@
+#ifndef CCLS_CLASS_CPP
+#define CCLS_CLASS_CPP
+
+#include "pids_class.cpp"
+#include "Random.h"
+#include "Timer.h"
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////
+//        CONFIGURATION CHECKING WITH WEIGHTING             //
+//////////////////////////////////////////////////////////////
+
+// NuMVC-style search for a PIDS of k nodes. Each node x has a weight that
+// grows by one every step x stays deficient (popularity[x] < need[x]),
+// and the search swaps a member out and a node in to lower the weighted
+// deficiency; every time it reaches zero the solution is recorded and the
+// member that costs least is dropped, so k shrinks.
+//   loss[u]: weight of the critical neighbors of u (popularity <= need),
+//            the deficiency a member u adds when it leaves
+//   gain[u]: weight of the deficient neighbors of u, the deficiency a
+//            non-member u removes when it joins
+// Members are kept in buckets by loss, so the cheapest removal is found
+// without a scan; losses from maxBucket up share the last bucket.
+// Configuration checking: a node that left may only join again once the
+// state of one of the thresholds it takes part in has changed.
+// When the average weight passes avgLimit all weights are scaled by rho.
+struct CCLocalSearch {
+    const Graph& g;
+    Random* rnd;
+    double avgLimit;
+    double rho = 0.3;
+    int maxBucket = 1 << 12;
+
+    vector<char> in;
+    vector<int> popularity;
+    vector<int64_t> weight;
+    vector<int64_t> loss;
+    vector<int64_t> gain;
+    vector<char> confChange;
+    vector<int64_t> age;           // step of the last move of the node
+    vector<int> deficient;         // nodes with popularity < need
+    vector<int> deficientPos;
+    int size = 0;
+    int64_t totalWeight = 0;
+
+    vector< vector<int> > buckets; // members by min(loss, maxBucket)
+    vector<int> bucketPos;
+    int lowest = 0;                // no member is in a lower bucket
+
+    vector<int> best;
+    int64_t it = 0;
+
+    // called with the new best size whenever it improves
+    function<void(int)> onImprove;
+
+    CCLocalSearch(const Graph& graph, Random* r)
+        : g(graph), rnd(r), avgLimit(graph.n/2.0), in(graph.n, 0), popularity(graph.n, 0),
+          weight(graph.n, 1), loss(graph.n, 0), gain(graph.n, 0), confChange(graph.n, 1),
+          age(graph.n, 0), deficientPos(graph.n, -1), buckets(maxBucket + 1), bucketPos(graph.n, -1) {
+        totalWeight = g.n;
+        for (int x = 0; x < g.n; x++) {
+            if (g.need[x] > 0) setDeficient(x, true);
+            for (const int* u = g.begin(x); u != g.end(x); ++u) {
+                loss[*u] += weight[x];
+                if (g.need[x] > 0) gain[*u] += weight[x];
+            }
+        }
+    }
+
+    void load(const vector<int>& start) {
+        for (int v : start)
+            if (not in[v]) add(v);
+        best.clear();
+        for (int v = 0; v < g.n; v++)
+            if (in[v]) best.push_back(v);
+    }
+
+    void add(int v) {
+        in[v] = 1;
+        size++;
+        age[v] = it;
+        file(v);
+        for (const int* x = g.begin(v); x != g.end(v); ++x) {
+            int p = ++popularity[*x];
+            int need = g.need[*x];
+            if (p == need) changed(*x, false, true);          // no longer deficient
+            else if (p == need + 1) changed(*x, true, false); // no longer critical
+        }
+    }
+
+    void remove(int v) {
+        in[v] = 0;
+        size--;
+        age[v] = it;
+        unfile(v);
+        for (const int* x = g.begin(v); x != g.end(v); ++x) {
+            int p = --popularity[*x];
+            int need = g.need[*x];
+            if (p == need) changed(*x, true, false);          // critical again
+            else if (p == need - 1) changed(*x, false, true); // deficient again
+        }
+        // the thresholds v changed count as its own move, not as a new configuration
+        confChange[v] = 0;
+    }
+
+    // Search for at most max_steps steps (-1 for no limit) or until the
+    // clock passes limit; best holds the smallest PIDS
+    void run(Timer& timer, Timer::TYPE clock, double limit, int64_t max_steps = -1) {
+        int64_t end = max_steps < 0 ? INT64_MAX : it + max_steps;
+        int tabu = -1;
+        while (size > 0 and it < end) {
+            if ((it & 255) == 0 and timer.elapsed_time(clock) > limit) break;
+            it++;
+            if (deficient.empty()) {
+                if (size < int(best.size()) or best.empty()) {
+                    best.clear();
+                    for (int v = 0; v < g.n; v++)
+                        if (in[v]) best.push_back(v);
+                    if (onImprove) onImprove(size);
+                }
+                remove(cheapest(-1));
+                continue;
+            }
+
+            int u = cheapest(tabu);
+            if (u >= 0) remove(u);
+
+            int x = deficient[int(rnd->next()*deficient.size()) % deficient.size()];
+            int pick = -1;
+            bool pickChecked = false;
+            for (const int* w = g.begin(x); w != g.end(x); ++w) {
+                int v = *w;
+                if (in[v]) continue;
+                bool checked = confChange[v];
+                if (pick < 0 or (checked and not pickChecked) or
+                    (checked == pickChecked and (gain[v] > gain[pick] or
+                                                 (gain[v] == gain[pick] and age[v] < age[pick])))) {
+                    pick = v;
+                    pickChecked = checked;
+                }
+            }
+            add(pick);
+            tabu = pick;
+
+            // the thresholds still unmet weigh more
+            for (int d : deficient) {
+                weight[d]++;
+                totalWeight++;
+                for (const int* w = g.begin(d); w != g.end(d); ++w) {
+                    if (in[*w]) unfile(*w);
+                    gain[*w]++;
+                    loss[*w]++;
+                    if (in[*w]) file(*w);
+                }
+            }
+            if (totalWeight > avgLimit*g.n) forget();
+        }
+    }
+
+private:
+    // Member with the least loss other than skip, -1 if there is none
+    int cheapest(int skip) {
+        for (int b = lowest; b <= maxBucket; b++) {
+            vector<int>& bucket = buckets[b];
+            if (bucket.empty()) {
+                if (b == lowest) lowest++;
+                continue;
+            }
+            int found = -1;
+            if (b < maxBucket) {
+                for (int k = int(bucket.size()) - 1; k >= 0 and found < 0; k--)
+                    if (bucket[k] != skip) found = bucket[k];
+            }
+            else {
+                // the last bucket is not sorted
+                for (int v : bucket)
+                    if (v != skip and (found < 0 or loss[v] < loss[found])) found = v;
+            }
+            if (found >= 0) return found;
+        }
+        return -1;
+    }
+
+    int key(int v) const { return loss[v] < maxBucket ? int(loss[v]) : maxBucket; }
+
+    void file(int v) {
+        int b = key(v);
+        bucketPos[v] = buckets[b].size();
+        buckets[b].push_back(v);
+        if (b < lowest) lowest = b;
+    }
+
+    void unfile(int v) {
+        vector<int>& bucket = buckets[key(v)];
+        int last = bucket.back();
+        bucket[bucketPos[v]] = last;
+        bucketPos[last] = bucketPos[v];
+        bucket.pop_back();
+        bucketPos[v] = -1;
+    }
+
+    // Node x stopped or started being critical and/or deficient
+    void changed(int x, bool critical, bool deficiency) {
+        bool nowCritical = popularity[x] <= g.need[x];
+        bool nowDeficient = popularity[x] < g.need[x];
+        if (deficiency) setDeficient(x, nowDeficient);
+        for (const int* u = g.begin(x); u != g.end(x); ++u) {
+            confChange[*u] = 1;
+            if (critical) {
+                if (in[*u]) unfile(*u);
+                loss[*u] += nowCritical ? weight[x] : -weight[x];
+                if (in[*u]) file(*u);
+            }
+            if (deficiency) gain[*u] += nowDeficient ? weight[x] : -weight[x];
+        }
+    }
+
+    void setDeficient(int x, bool on) {
+        if (on == (deficientPos[x] >= 0)) return;
+        if (on) {
+            deficientPos[x] = deficient.size();
+            deficient.push_back(x);
+        }
+        else {
+            int last = deficient.back();
+            deficient[deficientPos[x]] = last;
+            deficientPos[last] = deficientPos[x];
+            deficient.pop_back();
+            deficientPos[x] = -1;
+        }
+    }
+
+    // Scale all weights by rho and recompute the scores
+    void forget() {
+        totalWeight = 0;
+        for (int x = 0; x < g.n; x++) {
+            weight[x] = max<int64_t>(1, int64_t(rho*weight[x]));
+            totalWeight += weight[x];
+        }
+        for (int v = 0; v < g.n; v++) {
+            if (in[v]) unfile(v);
+            loss[v] = 0;
+            gain[v] = 0;
+        }
+        for (int x = 0; x < g.n; x++) {
+            bool critical = popularity[x] <= g.need[x];
+            bool deficientNow = popularity[x] < g.need[x];
+            for (const int* u = g.begin(x); u != g.end(x); ++u) {
+                if (critical) loss[*u] += weight[x];
+                if (deficientNow) gain[*u] += weight[x];
+            }
+        }
+        lowest = maxBucket;
+        for (int v = 0; v < g.n; v++)
+            if (in[v]) file(v);
+    }
+};
+
+#endif
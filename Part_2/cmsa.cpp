@@ -0,0 +1,311 @@
+/***************************************************************************
+    cmsa.cpp
+    (C) 2021 by C. Blum & M. Blesa
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Timer.h"
+#include "Random.h"
+#include "../Part_1/greedy_class.cpp"
+#include "pids_class.cpp"
+#include "cover_class.cpp"
+#include "thread_class.cpp"
+#include "bound_class.cpp"
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <fstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include <limits>
+#include <iomanip>
+
+// global variables concerning the random number generator (in case needed)
+time_t t;
+Random* rnd;
+
+// Data structures for the problem data
+int n_of_nodes;
+int n_of_arcs;
+vector< unordered_set<int> > neighbors;
+Graph graph;
+
+// string for keeping the name of the input file
+string inputFile;
+
+// computing time limit for each application of the metaheuristic
+double time_limit = 600.0;
+
+// number of applications of the metaheuristic
+int n_apps = 1;
+
+// solutions constructed per iteration and their determinism: the degree
+// of every node is scaled by a random factor in [1 - noise, 1]
+int n_constructions = 10;
+double noise = 0.3;
+
+// iterations a node may stay in the sub-instance without being used
+int max_age = 3;
+
+// time limit of every exact solve of the sub-instance
+double sub_time = 2.0;
+
+// threads that build the solutions
+int n_threads = 1;
+
+// passes of the LP lower bound printed next to every result, 0 to skip it
+int lb_iterations = 500;
+
+
+void read_parameters(int argc, char **argv) {
+
+    int iarg = 1;
+    while (iarg < argc) {
+        if (strcmp(argv[iarg],"-i") == 0) inputFile = argv[++iarg];
+        // reading the computation time limit
+        // from the command line (if provided)
+        else if (strcmp(argv[iarg],"-t") == 0) time_limit = atoi(argv[++iarg]);
+        // reading the number of applications of the metaheuristic
+        // from the command line (if provided)
+        else if (strcmp(argv[iarg],"-n_apps") == 0) n_apps = atoi(argv[++iarg]);
+        // reading the parameters of CMSA
+        else if (strcmp(argv[iarg],"-constructions") == 0) n_constructions = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-noise") == 0) noise = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-age") == 0) max_age = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-sub_time") == 0) sub_time = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-threads") == 0) n_threads = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-lb") == 0) lb_iterations = atoi(argv[++iarg]);
+        iarg++;
+    }
+}
+
+
+//////////////////////////////////////////////////////////////
+//                       CONSTRUCT                          //
+//////////////////////////////////////////////////////////////
+
+// greedyAux on the compressed graph with a randomized degree order:
+// the neighbors of the degree-one nodes go in first, then every node
+// that still has a neighbor under its threshold. Redundant members are
+// pruned as greedy() does.
+void randomizedGreedy(PIDSState& state, Random* r, vector< pair<double,int> >& order) {
+    state.init(graph);
+    order.resize(graph.n);
+    for (int v = 0; v < graph.n; v++)
+        order[v] = make_pair(-graph.degree(v)*(1.0 - noise*r->next()), v);
+    sort(order.begin(), order.end());
+
+    for (int v = 0; v < graph.n; v++) {
+        if (graph.degree(v) == 1 and not state.in[*graph.begin(v)]) state.add(*graph.begin(v));
+    }
+    for (const auto& p : order) {
+        int v = p.second;
+        if (state.in[v]) continue;
+        for (const int* x = graph.begin(v); x != graph.end(v); ++x) {
+            if (state.popularity[*x] < graph.need[*x]) {
+                state.add(v);
+                break;
+            }
+        }
+    }
+    state.pruneAll();
+}
+
+
+//////////////////////////////////////////////////////////////
+//                     MERGE, SOLVE & ADAPT                 //
+//////////////////////////////////////////////////////////////
+
+// Restricted problem: only the nodes of the sub-instance may be chosen,
+// every threshold has to be met by them
+CoverInstance subInstance(const vector<int>& sub, vector<int>& local) {
+    for (int k = 0; k < int(sub.size()); k++) local[sub[k]] = k;
+    CoverInstance inst(sub.size());
+    vector<int> cols;
+    for (int x = 0; x < graph.n; x++) {
+        if (graph.need[x] == 0) continue;
+        cols.clear();
+        for (const int* y = graph.begin(x); y != graph.end(x); ++y)
+            if (local[*y] >= 0) cols.push_back(local[*y]);
+        inst.addRow(cols, graph.need[x]);
+    }
+    inst.build();
+    for (int v : sub) local[v] = -1;
+    return inst;
+}
+
+void cmsa(Timer& timer, Timer::TYPE clock, ThreadPool& threads, double& result, double& time_stamp) {
+    vector<PIDSState> states(n_constructions);
+    vector<Random> streams;
+    vector< vector< pair<double,int> > > order(n_constructions);
+    for (int a = 0; a < n_constructions; a++) streams.push_back(Random(int(rnd->next()*2147483646) + 1));
+
+    vector<int> age(graph.n, -1); // -1 while the node is not in the sub-instance
+    vector<int> sub;
+    vector<int> local(graph.n, -1);
+    vector<int> best;
+    long iteration = 0;
+
+    while (timer.elapsed_time(clock) < time_limit) {
+        iteration++;
+        threads.run(n_constructions, [&](int a) {
+            randomizedGreedy(states[a], &streams[a], order[a]);
+        });
+        for (const PIDSState& s : states) {
+            if (best.empty() or s.size() < int(best.size())) best = s.members;
+            for (int v : s.members) {
+                if (age[v] < 0) sub.push_back(v);
+                age[v] = 0;
+            }
+        }
+
+        Timer solveTimer;
+        CoverInstance inst = subInstance(sub, local);
+        // the sub-solve never runs past the time limit
+        double remaining = max(0.0, time_limit - timer.elapsed_time(clock));
+        CoverSolver solver(inst, -1, min(sub_time, remaining));
+        vector<int> used;
+        if (solver.solve(best.size() + 1)) {
+            for (int k = 0; k < int(sub.size()); k++)
+                if (solver.solution[k]) used.push_back(sub[k]);
+        }
+        else used = best;
+        double solveTime = solveTimer.elapsed_time(Timer::REAL);
+        if (used.size() < best.size()) best = used;
+
+        if (best.size() < result) {
+            result = best.size();
+            time_stamp = timer.elapsed_time(clock);
+            cout << "value " << best.size() << "\ttime " << time_stamp << endl;
+        }
+        cout << "iteration " << iteration << "\tsub-instance " << sub.size() << "\tsolve time " << solveTime;
+        cout << (solver.optimal ? "\toptimal" : "\ttime limit") << endl;
+
+        // the nodes of the solution get younger, the rest older
+        for (int v : sub) age[v]++;
+        for (int v : used) age[v] = 0;
+        int kept = 0;
+        for (int v : sub) {
+            if (age[v] > max_age) age[v] = -1;
+            else sub[kept++] = v;
+        }
+        sub.resize(kept);
+    }
+
+    PIDSState state;
+    state.init(graph);
+    state.load(best);
+    if (not check_PIDS(state.toSet())) cout << "Error: solution is not a PIDS" << endl;
+}
+
+
+/**********
+Main function
+**********/
+
+int main( int argc, char **argv ) {
+
+    read_parameters(argc,argv);
+
+    // setting the output format for doubles to 2 decimals after the comma
+    std::cout << std::setprecision(2) << std::fixed;
+
+    // initializing the random number generator. A random number
+    // between 0 and 1 is obtained with: double rnum = rnd->next();
+    rnd = new Random((unsigned) time(&t));
+    rnd->next();
+
+    // vectors for storing the result and the computation time
+    // obtained by the <n_apps> applications of the metaheuristic
+    vector<double> results(n_apps, std::numeric_limits<int>::max());
+    vector<double> times(n_apps, 0.0);
+
+    // opening the corresponding input file and reading the problem data
+    ifstream indata;
+    indata.open(inputFile.c_str());
+    if (not indata) { // file couldn't be opened
+        cout << "Error: file could not be opened" << endl;
+    }
+
+    indata >> n_of_nodes;
+    indata >> n_of_arcs;
+    neighbors = vector< unordered_set<int> >(n_of_nodes);
+    int u, v;
+    while (indata >> u >> v) {
+        neighbors[u - 1].insert(v - 1);
+        neighbors[v - 1].insert(u - 1);
+    }
+    indata.close();
+    graph = buildGraph(neighbors);
+
+    // certified lower bound from the LP relaxation
+    int lower_bound = lpLowerBound(graph, lb_iterations);
+
+    setNeighbor (neighbors);
+
+    ThreadPool threads(n_threads);
+    // CPU time adds up over the threads, so use wall-clock time with several
+    Timer::TYPE clock = n_threads > 1 ? Timer::REAL : Timer::VIRTUAL;
+
+    // main loop over all applications of the metaheuristic
+    for (int na = 0; na < n_apps; ++na) {
+
+        // the computation time starts now
+        Timer timer;
+
+        cout << "start application " << na + 1 << endl;
+
+        cmsa(timer, clock, threads, results[na], times[na]);
+
+        printGap(lower_bound, results[na]);
+        cout << "end application " << na + 1 << endl;
+    }
+
+    // calculating the average of the results and computation times,
+    // and their standard deviations, and write them to the screen
+    double r_mean = 0.0;
+    int r_best = std::numeric_limits<int>::max();
+    double t_mean = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        r_mean = r_mean + results[i];
+        if (int(results[i]) < r_best) r_best = int(results[i]);
+        t_mean = t_mean + times[i];
+    }
+    r_mean = r_mean/double(results.size());
+    t_mean = t_mean/double(times.size());
+    double rsd = 0.0;
+    double tsd = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        rsd = rsd + pow(results[i]-r_mean,2.0);
+        tsd = tsd + pow(times[i]-t_mean,2.0);
+    }
+    rsd = rsd/double(results.size());
+    if (rsd > 0.0) {
+        rsd = sqrt(rsd);
+    }
+    tsd = tsd/double(results.size());
+    if (tsd > 0.0) {
+        tsd = sqrt(tsd);
+    }
+    // printing statistical information
+    cout << r_best << "\t" << r_mean << "\t" << rsd << "\t";
+    cout << t_mean << "\t" << tsd << endl;
+}
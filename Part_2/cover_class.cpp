@@ -0,0 +1,295 @@
+#ifndef COVER_CLASS_CPP
+#define COVER_CLASS_CPP
+
+#include "Timer.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <climits>
+#include <limits>
+#include <functional>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////
+//                     COVER INSTANCE                       //
+//////////////////////////////////////////////////////////////
+
+// Weighted multicover: min sum cost[j] x[j] subject to
+// sum coef[i][j] x[j] >= rhs[i] for every row i, x binary.
+// Rows are added one by one; build() creates the column view.
+struct CoverInstance {
+    int n_cols = 0;
+    int n_rows = 0;
+    vector<int> cost;
+    vector<int> rhs;
+    vector<int> rowStart = vector<int>(1, 0);
+    vector<int> rowCol;
+    vector<int> rowCoef;
+    vector<int> colStart;
+    vector<int> colRow;
+    vector<int> colCoef;
+
+    CoverInstance(int cols = 0) : n_cols(cols), cost(cols, 1) {}
+
+    void addRow(const vector<int>& cols, const vector<int>& coefs, int b) {
+        rowCol.insert(rowCol.end(), cols.begin(), cols.end());
+        rowCoef.insert(rowCoef.end(), coefs.begin(), coefs.end());
+        rowStart.push_back(rowCol.size());
+        rhs.push_back(b);
+        n_rows++;
+    }
+
+    void addRow(const vector<int>& cols, int b) {
+        addRow(cols, vector<int>(cols.size(), 1), b);
+    }
+
+    void build() {
+        colStart.assign(n_cols + 1, 0);
+        for (int j : rowCol) colStart[j + 1]++;
+        for (int j = 0; j < n_cols; j++) colStart[j + 1] += colStart[j];
+        colRow.resize(rowCol.size());
+        colCoef.resize(rowCol.size());
+        vector<int> fill(colStart.begin(), colStart.end() - 1);
+        for (int i = 0; i < n_rows; i++) {
+            for (int k = rowStart[i]; k < rowStart[i + 1]; k++) {
+                colRow[fill[rowCol[k]]] = i;
+                colCoef[fill[rowCol[k]]++] = rowCoef[k];
+            }
+        }
+    }
+};
+
+
+//////////////////////////////////////////////////////////////
+//                   BRANCH AND BOUND                       //
+//////////////////////////////////////////////////////////////
+
+// Depth-first branch and bound for a CoverInstance. Each node fixes a
+// column of the unmet row with the least slack, trying 1 before 0;
+// fixing a column to 0 forces the columns that row can no longer do
+// without. Nodes are cut with the larger of two bounds on the cost still
+// needed: the cheapest way to meet a single row, and a fractional
+// knapsack over the total residual demand.
+struct CoverSolver {
+    const CoverInstance& inst;
+    long nodeLimit;
+    double timeLimit;
+
+    vector<int> solution; // best assignment found, x[j] in {0, 1}
+    int bestCost = INT_MAX;
+    int rootBound = 0;
+    bool optimal = false; // the search finished within the limits
+    long nodes = 0;
+
+    // stop once the incumbent is within this relative gap of the root bound
+    double gap = 0.0;
+
+    // a bound known from elsewhere (e.g. an LP), raises the root bound
+    int lowerBound = 0;
+
+    // called with the cost of every new incumbent
+    function<void(int)> onImprove;
+
+    CoverSolver(const CoverInstance& instance, long node_limit = -1, double time_limit = -1.0)
+        : inst(instance), nodeLimit(node_limit), timeLimit(time_limit) {}
+
+    // Search for a solution cheaper than upperBound. Returns true if one was found
+    bool solve(int upperBound = INT_MAX) {
+        value.assign(inst.n_cols, -1);
+        covered.assign(inst.n_rows, 0);
+        potential.assign(inst.n_rows, 0);
+        for (int i = 0; i < inst.n_rows; i++)
+            for (int k = inst.rowStart[i]; k < inst.rowStart[i + 1]; k++) potential[i] += inst.rowCoef[k];
+        cost = 0;
+        trail.clear();
+        bestCost = upperBound;
+        nodes = 0;
+        stopped = false;
+        found = false;
+        done = false;
+        timer = Timer();
+
+        for (int i = 0; i < inst.n_rows; i++)
+            if (potential[i] < inst.rhs[i]) {
+                optimal = true;
+                return false;
+            }
+        propagateAll();
+
+        // rows met and columns fixed at the root stay so in the whole tree
+        activeRows.clear();
+        activeCols.clear();
+        for (int i = 0; i < inst.n_rows; i++)
+            if (residual(i) > 0) activeRows.push_back(i);
+        for (int j = 0; j < inst.n_cols; j++)
+            if (value[j] < 0) activeCols.push_back(j);
+        rootBound = max(lowerBound, cost + int(ceil(bound() - 1e-9)));
+        // nothing cheaper than upperBound can exist
+        if (rootBound >= bestCost) {
+            optimal = true;
+            return false;
+        }
+        targetCost = gap > 0.0 ? int(floor(rootBound/(1.0 - min(gap, 0.99)) + 1e-9)) : rootBound;
+        search();
+        optimal = not stopped;
+        return found;
+    }
+
+private:
+    vector<signed char> value;
+    vector<int> covered;   // sum of the coefficients of the columns at 1
+    vector<int> potential; // sum of the coefficients of the columns not at 0
+    int cost = 0;
+    vector<int> trail;
+    vector<int> activeRows;
+    vector<int> activeCols;
+    bool stopped = false;
+    bool found = false;
+    bool done = false;
+    int targetCost = 0;
+    Timer timer;
+
+    // scratch for the knapsack bound
+    vector< pair<double,int> > ratio;
+
+    int residual(int i) const { return max(0, inst.rhs[i] - covered[i]); }
+
+    bool fix(int j, int v) {
+        value[j] = v;
+        trail.push_back(j);
+        bool ok = true;
+        if (v == 1) cost += inst.cost[j];
+        for (int k = inst.colStart[j]; k < inst.colStart[j + 1]; k++) {
+            int i = inst.colRow[k];
+            if (v == 1) covered[i] += inst.colCoef[k];
+            else {
+                potential[i] -= inst.colCoef[k];
+                if (potential[i] < inst.rhs[i]) ok = false;
+            }
+        }
+        return ok;
+    }
+
+    void undo(size_t mark) {
+        while (trail.size() > mark) {
+            int j = trail.back();
+            trail.pop_back();
+            for (int k = inst.colStart[j]; k < inst.colStart[j + 1]; k++) {
+                int i = inst.colRow[k];
+                if (value[j] == 1) covered[i] -= inst.colCoef[k];
+                else potential[i] += inst.colCoef[k];
+            }
+            if (value[j] == 1) cost -= inst.cost[j];
+            value[j] = -1;
+        }
+    }
+
+    // Fix to 1 the free columns of row i that it cannot do without
+    void propagateRow(int i) {
+        if (covered[i] >= inst.rhs[i]) return;
+        int slack = potential[i] - inst.rhs[i];
+        for (int k = inst.rowStart[i]; k < inst.rowStart[i + 1]; k++)
+            if (value[inst.rowCol[k]] < 0 and inst.rowCoef[k] > slack) fix(inst.rowCol[k], 1);
+    }
+
+    void propagateAll() {
+        for (int i = 0; i < inst.n_rows; i++) propagateRow(i);
+    }
+
+    // Lower bound on the cost still needed to meet all rows
+    double bound() {
+        double rowBound = 0.0;
+        long demand = 0;
+        for (int i : activeRows) {
+            int r = residual(i);
+            if (r == 0) continue;
+            demand += r;
+            double cheapest = numeric_limits<double>::max();
+            for (int k = inst.rowStart[i]; k < inst.rowStart[i + 1]; k++)
+                if (value[inst.rowCol[k]] < 0)
+                    cheapest = min(cheapest, double(inst.cost[inst.rowCol[k]])/inst.rowCoef[k]);
+            rowBound = max(rowBound, r*cheapest);
+        }
+        if (demand == 0) return 0.0;
+
+        ratio.clear();
+        for (int j : activeCols) {
+            if (value[j] >= 0) continue;
+            int gain = 0;
+            for (int k = inst.colStart[j]; k < inst.colStart[j + 1]; k++)
+                gain += min(inst.colCoef[k], residual(inst.colRow[k]));
+            if (gain > 0) ratio.push_back(make_pair(double(inst.cost[j])/gain, gain));
+        }
+        sort(ratio.begin(), ratio.end());
+        double knapsack = 0.0;
+        long left = demand;
+        for (const auto& p : ratio) {
+            if (left <= 0) break;
+            long take = min(left, long(p.second));
+            knapsack += take*p.first;
+            left -= take;
+        }
+        return max(rowBound, knapsack);
+    }
+
+    void search() {
+        if (stopped or done) return;
+        nodes++;
+        if ((nodeLimit >= 0 and nodes > nodeLimit) or
+            (timeLimit >= 0.0 and (nodes & 255) == 0 and timer.elapsed_time(Timer::REAL) > timeLimit)) {
+            stopped = true;
+            return;
+        }
+        if (cost + ceil(bound() - 1e-9) >= bestCost) return;
+
+        // unmet row with the least slack; none left means a new best solution
+        int row = -1;
+        for (int i : activeRows) {
+            if (residual(i) == 0) continue;
+            if (row < 0 or potential[i] - inst.rhs[i] < potential[row] - inst.rhs[row] or
+                (potential[i] - inst.rhs[i] == potential[row] - inst.rhs[row] and residual(i) > residual(row)))
+                row = i;
+        }
+        if (row < 0) {
+            bestCost = cost;
+            solution.assign(inst.n_cols, 0);
+            for (int j = 0; j < inst.n_cols; j++) solution[j] = value[j] == 1;
+            found = true;
+            if (onImprove) onImprove(bestCost);
+            // the root bound is met: optimal. Within the gap: stop unproven
+            if (bestCost <= rootBound) done = true;
+            else if (bestCost <= targetCost) stopped = true;
+            return;
+        }
+
+        // its free column that helps the unmet rows most per unit of cost
+        int col = -1;
+        double colScore = -1.0;
+        for (int k = inst.rowStart[row]; k < inst.rowStart[row + 1]; k++) {
+            int j = inst.rowCol[k];
+            if (value[j] >= 0) continue;
+            int gain = 0;
+            for (int l = inst.colStart[j]; l < inst.colStart[j + 1]; l++)
+                gain += min(inst.colCoef[l], residual(inst.colRow[l]));
+            double score = double(gain)/inst.cost[j];
+            if (score > colScore) {
+                col = j;
+                colScore = score;
+            }
+        }
+
+        size_t mark = trail.size();
+        fix(col, 1);
+        search();
+        undo(mark);
+
+        if (fix(col, 0)) {
+            for (int k = inst.colStart[col]; k < inst.colStart[col + 1]; k++) propagateRow(inst.colRow[k]);
+            search();
+        }
+        undo(mark);
+    }
+};
+
+#endif
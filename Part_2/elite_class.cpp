@@ -0,0 +1,184 @@
+#ifndef ELITE_CLASS_CPP
+#define ELITE_CLASS_CPP
+
+#include "Random.h"
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <climits>
+#include <algorithm>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////
+//                       ELITE POOL                         //
+//////////////////////////////////////////////////////////////
+
+struct EliteSolution {
+    int size;
+    vector<int> members;
+    atomic<int> refs;               // slots and best holding it, plus one while it is pushed
+    EliteSolution* next = nullptr;  // retired entries waiting to be freed
+
+    EliteSolution(const vector<int>& m) : size(m.size()), members(m), refs(1) {}
+};
+
+// Best solutions found by a group of concurrent workers. Slots hold
+// pointers to immutable entries and are replaced with compare-and-swap,
+// so neither publishing nor reading takes a lock. Readers only copy an
+// entry between an enter and a leave of the readers counter; an entry
+// that lost its last slot is retired and freed by the next push that
+// sees no reader at all, so the pool holds about the entries in use
+// instead of every entry ever published. The trace of improvements of
+// the global best is kept whole, under a lock taken only on improvements.
+struct ElitePool {
+    struct TracePoint {
+        double time;
+        int size;
+        int worker;
+    };
+
+    vector< atomic<EliteSolution*> > slots;
+    atomic<EliteSolution*> best;
+    mutable atomic<int> readers;    // threads reading entries right now
+
+    ElitePool(int n_slots)
+        : slots(n_slots), best(nullptr), readers(0) {
+        for (auto& s : slots) s = nullptr;
+    }
+
+    ~ElitePool() {
+        for (auto& s : slots) release(s.load());
+        release(best.load());
+        freeRetired(retired);
+    }
+
+    // Offer a solution found by worker at the given time. Returns true if
+    // it improved the global best
+    bool push(const vector<int>& members, int worker, double time) {
+        collect();
+        Reader r(*this);
+        EliteSolution* e = new EliteSolution(members);
+        int size = e->size;
+
+        // replace the worst slot if the new solution beats it
+        for (int tries = 0; tries < 4; tries++) {
+            int worst = -1;
+            int worstSize = -1;
+            EliteSolution* seen = nullptr;
+            for (int k = 0; k < int(slots.size()); k++) {
+                EliteSolution* cur = slots[k].load();
+                int curSize = cur ? cur->size : INT_MAX;
+                if (curSize > worstSize) {
+                    worst = k;
+                    worstSize = curSize;
+                    seen = cur;
+                }
+            }
+            if (worstSize <= size) break;
+            e->refs++;
+            if (slots[worst].compare_exchange_strong(seen, e)) {
+                release(seen);
+                break;
+            }
+            e->refs--;
+        }
+
+        bool improved = false;
+        EliteSolution* cur = best.load();
+        e->refs++;
+        while (cur == nullptr or size < cur->size) {
+            if (best.compare_exchange_weak(cur, e)) {
+                release(cur);
+                lock_guard<mutex> lock(traceMutex);
+                trace.push_back(TracePoint{time, size, worker});
+                improved = true;
+                break;
+            }
+        }
+        if (not improved) e->refs--;
+        release(e);
+        return improved;
+    }
+
+    int bestSize() const {
+        Reader r(*this);
+        EliteSolution* e = best.load();
+        return e ? e->size : INT_MAX;
+    }
+
+    // Copy of the best solution, false while the pool is empty
+    bool copyBest(vector<int>& members) const {
+        Reader r(*this);
+        EliteSolution* e = best.load();
+        if (e) members = e->members;
+        return e != nullptr;
+    }
+
+    // Copy of a random elite solution, false while the pool is empty
+    bool sample(Random* rnd, vector<int>& members) const {
+        Reader r(*this);
+        int n = slots.size();
+        int first = int(rnd->next()*n) % n;
+        for (int k = 0; k < n; k++) {
+            EliteSolution* e = slots[(first + k) % n].load();
+            if (e) {
+                members = e->members;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Every improvement of the global best (time to target), by time
+    vector<TracePoint> timeline() {
+        lock_guard<mutex> lock(traceMutex);
+        vector<TracePoint> t = trace;
+        sort(t.begin(), t.end(), [](const TracePoint& a, const TracePoint& b) { return a.time < b.time; });
+        return t;
+    }
+
+private:
+    // holds the readers counter while entries are touched
+    struct Reader {
+        const ElitePool& p;
+        Reader(const ElitePool& pool) : p(pool) { p.readers++; }
+        ~Reader() { p.readers--; }
+    };
+
+    mutex retireMutex;
+    EliteSolution* retired = nullptr; // unreachable, readers may still copy them
+    mutex traceMutex;
+    vector<TracePoint> trace;
+
+    // Drop one hold on e; an entry nobody holds any more is retired
+    void release(EliteSolution* e) {
+        if (e == nullptr or --e->refs > 0) return;
+        lock_guard<mutex> lock(retireMutex);
+        e->next = retired;
+        retired = e;
+    }
+
+    // Retired entries are unreachable, so once no reader is in, none of
+    // them can be read any more
+    void collect() {
+        EliteSolution* safe = nullptr;
+        {
+            lock_guard<mutex> lock(retireMutex);
+            if (retired == nullptr or readers.load() > 0) return;
+            safe = retired;
+            retired = nullptr;
+        }
+        freeRetired(safe);
+    }
+
+    static void freeRetired(EliteSolution* e) {
+        while (e) {
+            EliteSolution* next = e->next;
+            delete e;
+            e = next;
+        }
+    }
+};
+
+#endif
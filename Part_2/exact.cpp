@@ -0,0 +1,192 @@
+/***************************************************************************
+    exact.cpp
+    (C) 2021 by C. Blum & M. Blesa
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Timer.h"
+#include "../Part_1/greedy_class.cpp"
+#include "pids_class.cpp"
+#include "exact_class.cpp"
+#include "bound_class.cpp"
+#include "symmetry_class.cpp"
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <fstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include <limits>
+#include <iomanip>
+
+// Data structures for the problem data
+int n_of_nodes;
+int n_of_arcs;
+vector< unordered_set<int> > neighbors;
+Graph graph;
+
+// string for keeping the name of the input file
+string inputFile;
+
+// computing time limit of the search
+double time_limit = 3200.0;
+
+// number of applications of the search
+int n_apps = 1;
+
+// threads that share the search tree
+int n_threads = 1;
+
+// passes of the LP bound used to stop early and to fix nodes by reduced
+// cost before the search, 0 to skip it
+int lb_iterations = 500;
+
+// 1 to search every class of twins in one order only, 0 to search all of them
+int symmetry = 1;
+
+
+void read_parameters(int argc, char **argv) {
+
+    int iarg = 1;
+    while (iarg < argc) {
+        if (strcmp(argv[iarg],"-i") == 0) inputFile = argv[++iarg];
+        else if (strcmp(argv[iarg],"-t") == 0) time_limit = atof(argv[++iarg]);
+        // reading the number of applications from the command line (if provided)
+        else if (strcmp(argv[iarg],"-n_apps") == 0) n_apps = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-threads") == 0) n_threads = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-lb") == 0) lb_iterations = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-sym") == 0) symmetry = atoi(argv[++iarg]);
+        iarg++;
+    }
+}
+
+
+// Main function
+
+int main( int argc, char **argv ) {
+
+    read_parameters(argc,argv);
+
+    // setting the output format for doubles to 2 decimals after the comma
+    std::cout << std::setprecision(2) << std::fixed;
+
+    // opening the corresponding input file and reading the problem data
+    ifstream indata;
+    indata.open(inputFile.c_str());
+    if (not indata) { // file couldn't be opened
+        cout << "Error: file could not be opened" << endl;
+    }
+
+    indata >> n_of_nodes;
+    indata >> n_of_arcs;
+    neighbors = vector< unordered_set<int> >(n_of_nodes);
+    int u, v;
+    while (indata >> u >> v) {
+        neighbors[u - 1].insert(v - 1);
+        neighbors[v - 1].insert(u - 1);
+    }
+    indata.close();
+    graph = buildGraph(neighbors);
+
+    // vectors for storing the result and the computation time
+    // obtained by the <n_apps> applications
+    vector<double> results(n_apps, std::numeric_limits<int>::max());
+    vector<double> times(n_apps, 0.0);
+
+    // main loop over all applications
+    for (int na = 0; na < n_apps; ++na) {
+
+        // the computation time starts now
+        Timer timer;
+
+        cout << "start application " << na + 1 << endl;
+
+        // CPU time adds up over the threads, so use wall-clock time with several
+        Timer::TYPE clock = n_threads > 1 ? Timer::REAL : Timer::VIRTUAL;
+
+        // the greedy solution is the first incumbent
+        setNeighbor (neighbors);
+        unordered_set<int> greedySolution = greedy();
+        vector<int> start(greedySolution.begin(), greedySolution.end());
+        cout << "greedy " << start.size() << endl;
+
+        ExactSolver solver(graph, n_threads, time_limit);
+        if (lb_iterations > 0) {
+            LPBound lp(graph);
+            lp.run(lb_iterations);
+            solver.lowerBound = lp.integerBound();
+            int n_fixed = lp.fixByReducedCost(start.size(), solver.fixed);
+            cout << "lower bound " << solver.lowerBound << "\tfixed " << n_fixed << endl;
+        }
+        if (symmetry) {
+            TwinClasses twins(graph);
+            cout << "twin classes " << twins.classes << "\ttwins " << twins.twins << endl;
+            solver.twinNext = twins.next;
+            solver.twinPrev = twins.prev;
+        }
+        solver.onImprove = [&](int size) {
+            cout << "value " << size << "\ttime " << timer.elapsed_time(clock) << endl;
+        };
+        solver.solve(start);
+
+        double ct = timer.elapsed_time(clock);
+        results[na] = solver.best;
+        times[na] = ct;
+        cout << "value " << solver.best << "\ttime " << ct << endl;
+        if (solver.optimal) cout << "optimality proven" << endl;
+        cout << "search nodes " << solver.nodes << "\tper second " << solver.nodes/max(ct, 1e-6);
+        cout << "\tsteals " << solver.steals << endl;
+
+        unordered_set<int> solution(solver.bestSolution.begin(), solver.bestSolution.end());
+        if (not check_PIDS(solution)) cout << "Error: solution is not a PIDS" << endl;
+        cout << "end application " << na + 1 << endl;
+    }
+
+    // calculating the average of the results and computation times,
+    // and their standard deviations, and write them to the screen
+    double r_mean = 0.0;
+    int r_best = std::numeric_limits<int>::max();
+    double t_mean = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        r_mean = r_mean + results[i];
+        if (int(results[i]) < r_best) r_best = int(results[i]);
+        t_mean = t_mean + times[i];
+    }
+    r_mean = r_mean/double(results.size());
+    t_mean = t_mean/double(times.size());
+    double rsd = 0.0;
+    double tsd = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        rsd = rsd + pow(results[i]-r_mean,2.0);
+        tsd = tsd + pow(times[i]-t_mean,2.0);
+    }
+    rsd = rsd/double(results.size());
+    if (rsd > 0.0) {
+        rsd = sqrt(rsd);
+    }
+    tsd = tsd/double(results.size());
+    if (tsd > 0.0) {
+        tsd = sqrt(tsd);
+    }
+    // printing statistical information
+    cout << r_best << "\t" << r_mean << "\t" << rsd << "\t";
+    cout << t_mean << "\t" << tsd << endl;
+}
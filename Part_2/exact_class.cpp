@@ -0,0 +1,397 @@
+#ifndef EXACT_CLASS_CPP
+#define EXACT_CLASS_CPP
+
+#include "Timer.h"
+#include "pids_class.cpp"
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include <climits>
+#include <cmath>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////
+//                     PARTIAL STATE                        //
+//////////////////////////////////////////////////////////////
+
+// Partial assignment of the branch and bound: every node is fixed in,
+// fixed out or free. The fixed sets are bitsets; every fix is recorded
+// in a trail so a subtree is left by undoing back to a mark.
+struct ExactState {
+    const Graph* g = nullptr;
+    vector<uint64_t> fixedIn;
+    vector<uint64_t> fixedOut;
+    vector<int> popularity; // neighbors fixed in
+    vector<int> freeCount;  // free neighbors
+    long totalDeficit = 0;  // sum of max(0, need[x] - popularity[x])
+    int size = 0;
+    vector<int> trail;
+
+    void init(const Graph& graph) {
+        g = &graph;
+        fixedIn.assign((g->n + 63)/64, 0);
+        fixedOut.assign((g->n + 63)/64, 0);
+        popularity.assign(g->n, 0);
+        freeCount.resize(g->n);
+        totalDeficit = 0;
+        for (int x = 0; x < g->n; x++) {
+            freeCount[x] = g->degree(x);
+            totalDeficit += g->need[x];
+        }
+        size = 0;
+        trail.clear();
+    }
+
+    bool isIn(int v) const { return fixedIn[v >> 6] >> (v & 63) & 1; }
+    bool isFree(int v) const { return not ((fixedIn[v >> 6] | fixedOut[v >> 6]) >> (v & 63) & 1); }
+    int deficit(int x) const { return max(0, g->need[x] - popularity[x]); }
+
+    // Returns false if some threshold can no longer be met
+    bool fix(int v, bool in) {
+        uint64_t bit = uint64_t(1) << (v & 63);
+        if (in) {
+            fixedIn[v >> 6] |= bit;
+            size++;
+        }
+        else fixedOut[v >> 6] |= bit;
+        trail.push_back(v);
+        bool ok = true;
+        for (const int* x = g->begin(v); x != g->end(v); ++x) {
+            freeCount[*x]--;
+            if (in) {
+                if (popularity[*x] < g->need[*x]) totalDeficit--;
+                popularity[*x]++;
+            }
+            else if (popularity[*x] + freeCount[*x] < g->need[*x]) ok = false;
+        }
+        return ok;
+    }
+
+    void undo(size_t mark) {
+        while (trail.size() > mark) {
+            int v = trail.back();
+            trail.pop_back();
+            bool in = isIn(v);
+            uint64_t bit = uint64_t(1) << (v & 63);
+            fixedIn[v >> 6] &= ~bit;
+            fixedOut[v >> 6] &= ~bit;
+            if (in) size--;
+            for (const int* x = g->begin(v); x != g->end(v); ++x) {
+                freeCount[*x]++;
+                if (in) {
+                    popularity[*x]--;
+                    if (popularity[*x] < g->need[*x]) totalDeficit++;
+                }
+            }
+        }
+    }
+
+    // A node that needs all of its free neighbors gets them
+    void forceRow(int x) {
+        if (deficit(x) == 0 or deficit(x) < freeCount[x]) return;
+        for (const int* w = g->begin(x); w != g->end(x); ++w)
+            if (isFree(*w)) fix(*w, true);
+    }
+
+    // Fix v out and force what that leaves no choice about
+    bool fixOut(int v) {
+        if (not fix(v, false)) return false;
+        for (const int* x = g->begin(v); x != g->end(v); ++x) forceRow(*x);
+        return true;
+    }
+
+    vector<int> members() const {
+        vector<int> m;
+        for (int w = 0; w < int(fixedIn.size()); w++)
+            for (uint64_t b = fixedIn[w]; b; b &= b - 1) m.push_back(64*w + __builtin_ctzll(b));
+        return m;
+    }
+};
+
+
+//////////////////////////////////////////////////////////////
+//                   BRANCH AND BOUND                       //
+//////////////////////////////////////////////////////////////
+
+// Exact MPIDS search. Every node branches on the free neighbor w that
+// helps most unmet nodes, next to the node with the largest unmet
+// threshold: first w in, then w out. A node is cut when its size plus
+// one of three bounds reaches the incumbent: the total deficit over the
+// maximum degree, a packing of unmet nodes with disjoint free
+// neighborhoods, whose deficits need distinct new members, and a dual
+// solution of the covering LP.
+//
+// Threads share the tree by work stealing: near the root a worker leaves
+// the second branch in its own deque and takes it back once the first
+// one is done, unless an idle worker stole it from the front meanwhile.
+// A stolen task is the list of branching decisions from the root.
+//
+// With twin classes set (see symmetry_class.cpp) a class is searched in
+// one order only: a twin that joins brings the twins before it, and a
+// twin that leaves takes the twins after it along.
+struct ExactSolver {
+    struct Task {
+        vector< pair<int,bool> > decisions;
+    };
+
+    struct Worker {
+        ExactState state;
+        deque<Task> tasks;
+        mutex m;
+        vector< pair<int,bool> > decisions;
+        vector<int> stamp; // packing bound marks
+        int now = 0;
+        vector<int> unmet; // unmet neighbors of every free node, for the dual bound
+        long nodes = 0;
+        Timer timer;
+    };
+
+    const Graph& g;
+    int n_threads;
+    double timeLimit;
+    int splitDepth = 24; // deepest level whose second branch can be stolen
+
+    // optional root fixes (-1 free, 0 out, 1 in), valid for every solution
+    // smaller than the start one, and a proven bound to stop at
+    vector<int> fixed;
+    int lowerBound = 0;
+
+    // optional twin chains (TwinClasses next and prev), empty for none
+    vector<int> twinNext;
+    vector<int> twinPrev;
+
+    int maxDegree = 0;
+    atomic<int> best;
+    vector<int> bestSolution;
+    mutex bestMutex;
+    atomic<long> nodes;
+    atomic<int> busy;
+    atomic<bool> stop;
+    atomic<bool> proven; // the incumbent met lowerBound
+    bool optimal = false;
+    atomic<long> steals;
+
+    // called with the size of every new incumbent, under a lock
+    function<void(int)> onImprove;
+
+    ExactSolver(const Graph& graph, int threads = 1, double time_limit = -1.0)
+        : g(graph), n_threads(max(1, threads)), timeLimit(time_limit),
+          best(INT_MAX), nodes(0), busy(0), stop(false), proven(false), steals(0) {
+        for (int v = 0; v < g.n; v++) maxDegree = max(maxDegree, g.degree(v));
+    }
+
+    // Search for a solution smaller than start. Returns true if one was found
+    bool solve(const vector<int>& start) {
+        best = start.empty() ? INT_MAX : int(start.size());
+        bestSolution = start;
+        int initial = best;
+        nodes = 0;
+        stop = false;
+        proven = best <= lowerBound;
+        steals = 0;
+
+        vector<Worker> workers(n_threads);
+        for (Worker& w : workers) {
+            w.state.init(g);
+            w.stamp.assign(g.n, 0);
+            w.unmet.assign(g.n, 0);
+        }
+        busy = 1;
+
+        vector<thread> pool;
+        for (int t = 1; t < n_threads; t++) pool.push_back(thread(&ExactSolver::work, this, ref(workers), t, false));
+        work(workers, 0, true);
+        for (thread& t : pool) t.join();
+
+        optimal = not stop;
+        return best < initial;
+    }
+
+private:
+    void work(vector<Worker>& workers, int id, bool owner) {
+        Worker& me = workers[id];
+        me.timer = Timer();
+        int victim = id;
+        while (true) {
+            Task task;
+            bool got = false;
+            if (owner) {
+                // the root task, counted as busy by solve(); it never goes
+                // through the deque, where the other workers could take it
+                got = true;
+                owner = false;
+            }
+            for (int k = 0; k < n_threads and not got; k++) {
+                victim = (victim + 1) % n_threads;
+                if (victim == id) continue;
+                lock_guard<mutex> lock(workers[victim].m);
+                if (not workers[victim].tasks.empty()) {
+                    task = workers[victim].tasks.front();
+                    workers[victim].tasks.pop_front();
+                    busy++;
+                    steals++;
+                    got = true;
+                }
+            }
+            if (not got) {
+                if (busy == 0 or stop or proven) break;
+                this_thread::yield();
+                continue;
+            }
+
+            me.state.init(g);
+            me.decisions = task.decisions;
+            bool ok = true;
+            for (int x = 0; x < g.n; x++) me.state.forceRow(x);
+            for (int v = 0; v < int(fixed.size()) and ok; v++) {
+                if (fixed[v] < 0 or not me.state.isFree(v)) continue;
+                if (fixed[v] == 1) me.state.fix(v, true);
+                else if (not me.state.fixOut(v)) ok = false;
+            }
+            for (const auto& d : task.decisions)
+                if (ok and not decide(me.state, d.first, d.second)) ok = false;
+            if (ok) search(me);
+            nodes += me.nodes;
+            me.nodes = 0;
+            busy--;
+        }
+    }
+
+    // Branching decision on v with the twins it brings along, false if
+    // some threshold can no longer be met or a twin is fixed the other way
+    bool decide(ExactState& s, int v, bool in) {
+        if (in) s.fix(v, true);
+        else if (not s.fixOut(v)) return false;
+        if (twinNext.empty()) return true;
+        const vector<int>& chain = in ? twinPrev : twinNext;
+        for (int t = chain[v]; t >= 0; t = chain[t]) {
+            if (not s.isFree(t)) {
+                if (s.isIn(t) != in) return false;
+            }
+            else if (in) s.fix(t, true);
+            else if (not s.fixOut(t)) return false;
+        }
+        return true;
+    }
+
+    // Greedy packing of unmet nodes with pairwise disjoint free neighborhoods
+    long packingBound(Worker& me) {
+        const ExactState& s = me.state;
+        me.now++;
+        long bound = 0;
+        for (int x = 0; x < g.n; x++) {
+            int d = s.deficit(x);
+            if (d == 0) continue;
+            bool disjoint = true;
+            for (const int* w = g.begin(x); w != g.end(x) and disjoint; ++w)
+                if (s.isFree(*w) and me.stamp[*w] == me.now) disjoint = false;
+            if (not disjoint) continue;
+            for (const int* w = g.begin(x); w != g.end(x); ++w)
+                if (s.isFree(*w)) me.stamp[*w] = me.now;
+            bound += d;
+        }
+        return bound;
+    }
+
+    // Dual bound: y[x] = 1/max{unmet[w] : w free next to x} is a feasible
+    // dual of the covering LP, so sum deficit[x]*y[x] bounds the nodes still needed
+    double dualBound(Worker& me) {
+        const ExactState& s = me.state;
+        for (int w = 0; w < g.n; w++) {
+            if (not s.isFree(w)) continue;
+            int c = 0;
+            for (const int* x = g.begin(w); x != g.end(w); ++x)
+                if (s.deficit(*x) > 0) c++;
+            me.unmet[w] = c;
+        }
+        double bound = 0.0;
+        for (int x = 0; x < g.n; x++) {
+            int d = s.deficit(x);
+            if (d == 0) continue;
+            int most = 1;
+            for (const int* w = g.begin(x); w != g.end(x); ++w)
+                if (s.isFree(*w)) most = max(most, me.unmet[*w]);
+            bound += double(d)/most;
+        }
+        return bound;
+    }
+
+    void search(Worker& me) {
+        ExactState& s = me.state;
+        if (stop or proven) return;
+        if ((++me.nodes & 1023) == 0 and timeLimit >= 0.0 and me.timer.elapsed_time(Timer::REAL) > timeLimit) {
+            stop = true;
+            return;
+        }
+        int incumbent = best;
+        long deficitBound = (s.totalDeficit + maxDegree - 1)/max(maxDegree, 1);
+        if (s.size + deficitBound >= incumbent) return;
+        if (s.size + packingBound(me) >= incumbent) return;
+        if (s.size + ceil(dualBound(me) - 1e-9) >= incumbent) return;
+
+        // unmet node with the largest deficit, the least slack on ties
+        int row = -1;
+        for (int x = 0; x < g.n; x++) {
+            int d = s.deficit(x);
+            if (d == 0) continue;
+            if (row < 0 or d > s.deficit(row) or
+                (d == s.deficit(row) and s.freeCount[x] < s.freeCount[row])) row = x;
+        }
+        if (row < 0) {
+            lock_guard<mutex> lock(bestMutex);
+            if (s.size < best) {
+                best = s.size;
+                bestSolution = s.members();
+                if (onImprove) onImprove(s.size);
+                if (s.size <= lowerBound) proven = true;
+            }
+            return;
+        }
+
+        int col = -1;
+        int colGain = -1;
+        for (const int* w = g.begin(row); w != g.end(row); ++w) {
+            if (not s.isFree(*w)) continue;
+            int gain = 0;
+            for (const int* y = g.begin(*w); y != g.end(*w); ++y)
+                if (s.deficit(*y) > 0) gain++;
+            if (gain > colGain) {
+                col = *w;
+                colGain = gain;
+            }
+        }
+
+        size_t mark = s.trail.size();
+        bool shared = int(me.decisions.size()) < splitDepth and n_threads > 1;
+        if (shared) {
+            Task task;
+            task.decisions = me.decisions;
+            task.decisions.push_back(make_pair(col, false));
+            lock_guard<mutex> lock(me.m);
+            me.tasks.push_back(task);
+        }
+
+        me.decisions.push_back(make_pair(col, true));
+        if (decide(s, col, true)) search(me);
+        s.undo(mark);
+        me.decisions.pop_back();
+
+        if (shared) {
+            // our task is at the back unless it has been stolen
+            lock_guard<mutex> lock(me.m);
+            if (me.tasks.empty()) return;
+            me.tasks.pop_back();
+        }
+        me.decisions.push_back(make_pair(col, false));
+        if (decide(s, col, false)) search(me);
+        s.undo(mark);
+        me.decisions.pop_back();
+    }
+};
+
+#endif
@@ -0,0 +1,196 @@
+/***************************************************************************
+    export_mpids.cpp
+    (C) 2021 by C. Blum & M. Blesa
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Timer.h"
+#include "Random.h"
+#include "../Part_1/greedy_class.cpp"
+#include "tabu_class.cpp"
+#include "bound_class.cpp"
+#include "writer_class.cpp"
+#include "symmetry_class.cpp"
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <fstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include <limits>
+#include <iomanip>
+
+// global variables concerning the random number generator (in case needed)
+time_t t;
+Random* rnd;
+
+// Data structures for the problem data
+int n_of_nodes;
+int n_of_arcs;
+vector< unordered_set<int> > neighbors;
+Graph graph;
+
+// string for keeping the name of the input file
+string inputFile;
+
+// model file: .lp, .mps, .opb or .wcnf, followed by .gz to compress it. The mapping
+// to the input node ids goes to the same name with .map appended
+string outputFile;
+
+// 1 to fix variables by LP reduced cost, as mip_mpids -fix does, against
+// the greedy solution improved by <tabu_iterations> of tabu search
+int reduce = 0;
+int64_t tabu_iterations = 20000;
+int lb_iterations = 500;
+
+// 1 to add rows that order every class of twins (see symmetry_class.cpp)
+int symmetry = 0;
+
+
+void read_parameters(int argc, char **argv) {
+
+    int iarg = 1;
+    while (iarg < argc) {
+        if (strcmp(argv[iarg],"-i") == 0) inputFile = argv[++iarg];
+        else if (strcmp(argv[iarg],"-o") == 0) outputFile = argv[++iarg];
+        else if (strcmp(argv[iarg],"-fix") == 0) reduce = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-tabu") == 0) tabu_iterations = atoll(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-lb") == 0) lb_iterations = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-sym") == 0) symmetry = atoi(argv[++iarg]);
+        iarg++;
+    }
+}
+
+bool endsWith(const string& s, const string& suffix) {
+    return s.size() >= suffix.size() and s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+
+// Main function
+
+int main( int argc, char **argv ) {
+
+    read_parameters(argc,argv);
+
+    // setting the output format for doubles to 2 decimals after the comma
+    std::cout << std::setprecision(2) << std::fixed;
+
+    string format = outputFile;
+    if (endsWith(format, ".gz")) format.resize(format.size() - 3);
+    size_t dot = format.rfind('.');
+    format = dot == string::npos ? "" : format.substr(dot + 1);
+    if (format != "lp" and format != "mps" and format != "opb" and format != "wcnf") {
+        cout << "Error: the output file has to end in .lp, .mps, .opb or .wcnf, optionally followed by .gz" << endl;
+        return 1;
+    }
+
+    // opening the corresponding input file and reading the problem data
+    ifstream indata;
+    indata.open(inputFile.c_str());
+    if (not indata) { // file couldn't be opened
+        cout << "Error: file could not be opened" << endl;
+    }
+
+    indata >> n_of_nodes;
+    indata >> n_of_arcs;
+    neighbors = vector< unordered_set<int> >(n_of_nodes);
+    int u, v;
+    while (indata >> u >> v) {
+        neighbors[u - 1].insert(v - 1);
+        neighbors[v - 1].insert(u - 1);
+    }
+    indata.close();
+    graph = buildGraph(neighbors);
+
+    // the computation time starts now
+    Timer timer;
+
+    // reduced-cost fixing keeps only the solutions smaller than the heuristic one
+    vector<int> fixed(n_of_nodes, -1);
+    int heuristic = -1;
+    int n_reduced = 0;
+    if (reduce) {
+        setNeighbor (neighbors);
+        unordered_set<int> greedySolution = greedy();
+        rnd = new Random((unsigned) time(&t));
+        rnd->next();
+        PIDSState state;
+        state.init(graph);
+        state.load(greedySolution);
+        int64_t tenure = 10 + graph.n/100;
+        TabuEngine tabu(state, rnd, tenure, tenure);
+        tabu.run(timer, numeric_limits<double>::max(), tabu_iterations);
+        heuristic = state.size();
+        LPBound lp(graph);
+        lp.run(lb_iterations);
+        n_reduced = lp.fixByReducedCost(heuristic, fixed);
+        cout << "heuristic " << heuristic << "\tlower bound " << lp.integerBound() << endl;
+        if (lp.integerBound() >= heuristic) cout << "the heuristic solution is optimal" << endl;
+    }
+    // a node that needs all its neighbors forces them into every PIDS
+    for (int i = 0; i < graph.n; i++) {
+        if (graph.need[i] < graph.degree(i)) continue;
+        for (const int* w = graph.begin(i); w != graph.end(i); ++w) fixed[*w] = 1;
+    }
+    // and a free node in no row left is 0 in every optimal solution
+    vector<int> residual = graph.need;
+    for (int w = 0; w < graph.n; w++) {
+        if (fixed[w] != 1) continue;
+        for (const int* i = graph.begin(w); i != graph.end(w); ++i) residual[*i]--;
+    }
+    for (int w = 0; w < graph.n; w++) {
+        if (fixed[w] >= 0) continue;
+        bool inRow = false;
+        for (const int* i = graph.begin(w); i != graph.end(w) and not inRow; ++i) inRow = residual[*i] > 0;
+        if (not inRow) fixed[w] = 0;
+    }
+
+    ModelWriter writer(graph, fixed);
+    if (symmetry) {
+        TwinClasses twins(graph);
+        writer.setOrder(twins.orderPairs(fixed));
+        cout << "twin classes " << twins.classes << "\ttwins " << twins.twins;
+        cout << "\tsymmetry rows " << writer.order.size() << endl;
+    }
+    ModelStream out;
+    if (not out.open(outputFile)) {
+        cout << "Error: file " << outputFile << " could not be opened" << endl;
+        return 1;
+    }
+    if (format == "lp") writer.writeLP(out, inputFile);
+    else if (format == "mps") writer.writeMPS(out, inputFile);
+    else if (format == "opb") writer.writeOPB(out, inputFile);
+    else writer.writeWCNF(out, inputFile);
+    out.close();
+
+    ModelStream map;
+    if (not map.open(outputFile + ".map")) {
+        cout << "Error: file " << outputFile << ".map could not be opened" << endl;
+        return 1;
+    }
+    if (n_reduced > 0) map.print("# the model only holds the solutions smaller than %d\n", heuristic);
+    writer.writeMapping(map);
+    map.close();
+
+    cout << "variables " << writer.n_vars << "\trows " << writer.n_rows;
+    cout << "\tfixed to 1 " << writer.offset << "\tfixed to 0 " << n_of_nodes - writer.n_vars - writer.offset;
+    cout << "\ttime " << timer.elapsed_time(Timer::VIRTUAL) << endl;
+}
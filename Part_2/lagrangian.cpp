@@ -0,0 +1,293 @@
+/***************************************************************************
+    lagrangian.cpp
+    (C) 2021 by C. Blum & M. Blesa
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Timer.h"
+#include "Random.h"
+#include "../Part_1/greedy_class.cpp"
+#include "pids_class.cpp"
+#include "bound_class.cpp"
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <fstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include <limits>
+#include <iomanip>
+
+// global variables concerning the random number generator (in case needed)
+time_t t;
+Random* rnd;
+
+// Data structures for the problem data
+int n_of_nodes;
+int n_of_arcs;
+vector< unordered_set<int> > neighbors;
+Graph graph;
+
+// string for keeping the name of the input file
+string inputFile;
+
+// computing time limit for each application
+double time_limit = 600.0;
+
+// number of applications
+int n_apps = 1;
+
+// maximum number of subgradient iterations, -1 for no limit
+long max_iterations = -1;
+
+// initial step factor of the subgradient method; it is halved after
+// <patience> iterations without a better bound. Once it falls below
+// <min_step> the method restarts from the best multipliers, raised by
+// coordinate ascent and scaled at random by 0.5..1.5, until the time limit
+double step_factor = 2.0;
+int patience = 30;
+double min_step = 1e-4;
+
+// a feasible solution is built from the Lagrangian costs every <primal>
+// iterations
+int primal_every = 10;
+
+
+void read_parameters(int argc, char **argv) {
+
+    int iarg = 1;
+    while (iarg < argc) {
+        if (strcmp(argv[iarg],"-i") == 0) inputFile = argv[++iarg];
+        else if (strcmp(argv[iarg],"-t") == 0) time_limit = atof(argv[++iarg]);
+        // reading the number of applications from the command line (if provided)
+        else if (strcmp(argv[iarg],"-n_apps") == 0) n_apps = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-iter") == 0) max_iterations = atol(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-step") == 0) step_factor = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-patience") == 0) patience = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-min_step") == 0) min_step = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-primal") == 0) primal_every = atoi(argv[++iarg]);
+        iarg++;
+    }
+}
+
+// Feasible solution from the Lagrangian costs c[v] = 1 - load[v]: start
+// from the Lagrangian solution (the nodes with c[v] < 0), let every
+// deficient node take its cheapest non-member neighbors and drop the
+// redundant members, most expensive first
+void lagrangianHeuristic(PIDSState& state, const vector<double>& load) {
+    state.init(graph);
+    for (int v = 0; v < graph.n; v++)
+        if (load[v] > 1.0) state.add(v);
+    for (int x = 0; x < graph.n and not state.feasible(); x++) {
+        while (state.popularity[x] < graph.need[x]) {
+            int best = -1;
+            for (const int* w = graph.begin(x); w != graph.end(x); ++w) {
+                if (state.in[*w]) continue;
+                if (best < 0 or load[*w] > load[best] or
+                    (load[*w] == load[best] and graph.degree(*w) > graph.degree(best))) best = *w;
+            }
+            state.add(best);
+        }
+    }
+    vector<int> cand;
+    for (int v : state.members)
+        if (state.critical[v] == 0) cand.push_back(v);
+    sort(cand.begin(), cand.end(), [&](int a, int b) {
+        if (load[a] != load[b]) return load[a] < load[b];
+        return a < b;
+    });
+    state.prune(cand);
+}
+
+
+// Main function
+
+int main( int argc, char **argv ) {
+
+    read_parameters(argc,argv);
+
+    // setting the output format for doubles to 2 decimals after the comma
+    std::cout << std::setprecision(2) << std::fixed;
+
+    // opening the corresponding input file and reading the problem data
+    ifstream indata;
+    indata.open(inputFile.c_str());
+    if (not indata) { // file couldn't be opened
+        cout << "Error: file could not be opened" << endl;
+    }
+
+    indata >> n_of_nodes;
+    indata >> n_of_arcs;
+    neighbors = vector< unordered_set<int> >(n_of_nodes);
+    int u, v;
+    while (indata >> u >> v) {
+        neighbors[u - 1].insert(v - 1);
+        neighbors[v - 1].insert(u - 1);
+    }
+    indata.close();
+    graph = buildGraph(neighbors);
+
+    // initializing the random number generator. A random number
+    // between 0 and 1 is obtained with: double rnum = rnd->next();
+    rnd = new Random((unsigned) time(&t));
+    rnd->next();
+
+    // vectors for storing the result and the computation time
+    // obtained by the <n_apps> applications
+    vector<double> results(n_apps, std::numeric_limits<int>::max());
+    vector<double> times(n_apps, 0.0);
+
+    setNeighbor (neighbors);
+
+    // main loop over all applications
+    for (int na = 0; na < n_apps; ++na) {
+
+        // the computation time starts now
+        Timer timer;
+
+        cout << "start application " << na + 1 << endl;
+
+        // the greedy solution is the first incumbent and the first step target
+        unordered_set<int> greedySolution = greedy();
+        vector<int> best(greedySolution.begin(), greedySolution.end());
+        results[na] = best.size();
+        times[na] = timer.elapsed_time(Timer::VIRTUAL);
+        cout << "value " << best.size() << "\ttime " << times[na] << endl;
+        auto improve = [&](const vector<int>& members) {
+            if (members.size() >= best.size()) return;
+            best = members;
+            results[na] = best.size();
+            times[na] = timer.elapsed_time(Timer::VIRTUAL);
+            cout << "value " << best.size() << "\ttime " << times[na] << endl;
+        };
+
+        // every multiplier vector y gives the bound LB(y) of LPBound, which is
+        // the Lagrangian bound as well: the relaxed problem is solved by
+        // x[v] = 1 exactly when the Lagrangian cost 1 - load[v] is negative
+        LPBound lp(graph);
+        vector<double> grad(graph.n);
+        vector<double> bestY = lp.y;
+        double bestBound = lp.evaluate(grad);
+        int lower_bound = lp.integerBound();
+        cout << "bound " << lower_bound << "\ttime " << timer.elapsed_time(Timer::VIRTUAL) << endl;
+        auto raise = [&]() {
+            if (lp.value > bestBound + 1e-9) {
+                bestBound = lp.value;
+                bestY = lp.y;
+            }
+            if (lp.integerBound() > lower_bound) {
+                lower_bound = lp.integerBound();
+                cout << "bound " << lower_bound << "\ttime " << timer.elapsed_time(Timer::VIRTUAL) << endl;
+            }
+        };
+
+        PIDSState state;
+        double mu = step_factor;
+        int stall = 0;
+        long it = 0;
+        int restarts = 0;
+        while (timer.elapsed_time(Timer::VIRTUAL) <= time_limit and (max_iterations < 0 or it < max_iterations)
+               and lower_bound < int(best.size())) {
+            if (mu < min_step) {
+                // the step collapsed: ascent from the best multipliers, a
+                // primal solution from them, and a new start nearby
+                lp.y = bestY;
+                lp.certify();
+                lp.ascend(20);
+                raise();
+                lagrangianHeuristic(state, lp.load);
+                improve(state.members);
+                for (double& y : lp.y) y *= 0.5 + rnd->next();
+                lp.evaluate(grad);
+                mu = step_factor;
+                stall = 0;
+                restarts++;
+                continue;
+            }
+            if (it % primal_every == 0) {
+                lagrangianHeuristic(state, lp.load);
+                improve(state.members);
+            }
+            it++;
+            // Polyak step towards the best solution known; a zero subgradient
+            // leaves nothing to step along, so restart
+            if (not lp.step(grad, best.size(), mu)) {
+                mu = 0.0;
+                continue;
+            }
+            lp.evaluate(grad);
+            if (lp.value > bestBound + 1e-9) {
+                stall = 0;
+                raise();
+            }
+            else if (++stall >= patience) {
+                mu /= 2.0;
+                stall = 0;
+            }
+        }
+
+        // coordinate ascent from the best multipliers closes the last bit
+        lp.y = bestY;
+        lp.certify();
+        lp.ascend(20);
+        raise();
+        lagrangianHeuristic(state, lp.load);
+        improve(state.members);
+
+        printGap(lower_bound, best.size());
+        if (lower_bound >= int(best.size())) cout << "optimality proven" << endl;
+        cout << "iterations " << it << "\trestarts " << restarts << endl;
+
+        unordered_set<int> solution(best.begin(), best.end());
+        if (not check_PIDS(solution)) cout << "Error: solution is not a PIDS" << endl;
+        cout << "end application " << na + 1 << endl;
+    }
+
+    // calculating the average of the results and computation times,
+    // and their standard deviations, and write them to the screen
+    double r_mean = 0.0;
+    int r_best = std::numeric_limits<int>::max();
+    double t_mean = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        r_mean = r_mean + results[i];
+        if (int(results[i]) < r_best) r_best = int(results[i]);
+        t_mean = t_mean + times[i];
+    }
+    r_mean = r_mean/double(results.size());
+    t_mean = t_mean/double(times.size());
+    double rsd = 0.0;
+    double tsd = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        rsd = rsd + pow(results[i]-r_mean,2.0);
+        tsd = tsd + pow(times[i]-t_mean,2.0);
+    }
+    rsd = rsd/double(results.size());
+    if (rsd > 0.0) {
+        rsd = sqrt(rsd);
+    }
+    tsd = tsd/double(results.size());
+    if (tsd > 0.0) {
+        tsd = sqrt(tsd);
+    }
+    // printing statistical information
+    cout << r_best << "\t" << r_mean << "\t" << rsd << "\t";
+    cout << t_mean << "\t" << tsd << endl;
+}
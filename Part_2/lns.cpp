@@ -0,0 +1,346 @@
+/***************************************************************************
+    lns.cpp
+    (C) 2021 by C. Blum & M. Blesa
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Timer.h"
+#include "Random.h"
+#include "../Part_1/greedy_class.cpp"
+#include "pids_class.cpp"
+#include "cover_class.cpp"
+#include "thread_class.cpp"
+#include "bound_class.cpp"
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <fstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include <limits>
+#include <iomanip>
+
+// global variables concerning the random number generator (in case needed)
+time_t t;
+Random* rnd;
+
+// Data structures for the problem data
+int n_of_nodes;
+int n_of_arcs;
+vector< unordered_set<int> > neighbors;
+Graph graph;
+
+// string for keeping the name of the input file
+string inputFile;
+
+// computing time limit for each application of the metaheuristic
+double time_limit = 600.0;
+
+// number of applications of the metaheuristic
+int n_apps = 1;
+
+// nodes freed per region and regions solved per round
+int region_size = 100;
+int n_regions = 4;
+
+// limits of every exact sub-solve
+long node_limit = 200000;
+double sub_time = 0.2;
+
+// threads that solve the regions
+int n_threads = 1;
+
+// passes of the LP lower bound printed next to every result, 0 to skip it
+int lb_iterations = 500;
+
+
+void read_parameters(int argc, char **argv) {
+
+    int iarg = 1;
+    while (iarg < argc) {
+        if (strcmp(argv[iarg],"-i") == 0) inputFile = argv[++iarg];
+        // reading the computation time limit
+        // from the command line (if provided)
+        else if (strcmp(argv[iarg],"-t") == 0) time_limit = atoi(argv[++iarg]);
+        // reading the number of applications of the metaheuristic
+        // from the command line (if provided)
+        else if (strcmp(argv[iarg],"-n_apps") == 0) n_apps = atoi(argv[++iarg]);
+        // reading the size of the neighborhoods and the sub-solver limits
+        else if (strcmp(argv[iarg],"-region") == 0) region_size = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-regions") == 0) n_regions = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-nodes") == 0) node_limit = atol(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-sub_time") == 0) sub_time = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-threads") == 0) n_threads = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-lb") == 0) lb_iterations = atoi(argv[++iarg]);
+        iarg++;
+    }
+}
+
+
+//////////////////////////////////////////////////////////////
+//                LARGE NEIGHBORHOOD SEARCH                 //
+//////////////////////////////////////////////////////////////
+
+// Connected region of at most size nodes grown breadth-first from a
+// random member, skipping the nodes already taken by another region
+vector<int> growRegion(const PIDSState& state, vector<char>& taken, int size) {
+    vector<int> region;
+    int seed = state.members[int(rnd->next()*state.size()) % state.size()];
+    if (taken[seed]) return region;
+    region.push_back(seed);
+    taken[seed] = 1;
+    for (int head = 0; head < int(region.size()) and int(region.size()) < size; head++) {
+        int v = region[head];
+        int deg = graph.degree(v);
+        int first = deg > 0 ? int(rnd->next()*deg) % deg : 0;
+        for (int k = 0; k < deg and int(region.size()) < size; k++) {
+            int x = graph.begin(v)[(first + k) % deg];
+            if (taken[x]) continue;
+            taken[x] = 1;
+            region.push_back(x);
+        }
+    }
+    return region;
+}
+
+struct RegionResult {
+    vector<int> region;
+    vector<int> chosen; // new members inside the region
+    int before = 0;
+    bool improved = false;
+    bool optimal = false;
+    long nodes = 0;
+};
+
+// Everything outside the region stays fixed: each node next to the region
+// becomes a row that needs what the fixed members do not already give it
+// local and seen are per-thread scratch arrays over the nodes, left as found
+void solveRegion(const PIDSState& state, RegionResult& res, vector<int>& local, vector<char>& seen) {
+    const vector<int>& region = res.region;
+    for (int k = 0; k < int(region.size()); k++) local[region[k]] = k;
+
+    CoverInstance inst(region.size());
+    vector<int> rowOf;
+    vector<int> cols;
+    for (int v : region) {
+        for (const int* x = graph.begin(v); x != graph.end(v); ++x) {
+            if (seen[*x]) continue;
+            seen[*x] = 1;
+            rowOf.push_back(*x);
+            cols.clear();
+            int inside = 0;
+            for (const int* y = graph.begin(*x); y != graph.end(*x); ++y) {
+                if (local[*y] < 0) continue;
+                cols.push_back(local[*y]);
+                if (state.in[*y]) inside++;
+            }
+            int need = graph.need[*x] - (state.popularity[*x] - inside);
+            if (need > 0) inst.addRow(cols, need);
+        }
+    }
+    inst.build();
+
+    for (int v : region)
+        if (state.in[v]) res.before++;
+    CoverSolver solver(inst, node_limit, sub_time);
+    res.improved = solver.solve(res.before);
+    res.optimal = solver.optimal;
+    res.nodes = solver.nodes;
+    if (res.improved)
+        for (int k = 0; k < int(region.size()); k++)
+            if (solver.solution[k]) res.chosen.push_back(region[k]);
+
+    for (int v : region) local[v] = -1;
+    for (int x : rowOf) seen[x] = 0;
+}
+
+// Free and re-solve regions until the time limit. Regions are solved in
+// parallel against the same solution and merged one by one; a merge that
+// breaks a threshold (two regions sharing a neighbor) is undone. The
+// region size starts from <region_size> in every application, grows while
+// most sub-solves are proven optimal and shrinks while they run into the
+// limits.
+void largeNeighborhoodSearch(PIDSState& state, Timer& timer, Timer::TYPE clock,
+                             ThreadPool& threads, double& result, double& time_stamp) {
+    vector<int> trail;
+    state.trail = &trail;
+    vector< vector<int> > local(n_regions, vector<int>(graph.n, -1));
+    vector< vector<char> > seen(n_regions, vector<char>(graph.n, 0));
+    vector<char> taken(graph.n, 0);
+
+    long rounds = 0;
+    long solved = 0;
+    long proven = 0;
+    long merged = 0;
+    long nodes = 0;
+
+    int size = region_size;
+    int maxRegion = 4*region_size;
+    while (timer.elapsed_time(clock) < time_limit and state.size() > 0) {
+        rounds++;
+        int roundProven = 0;
+        int roundSolved = 0;
+        vector<RegionResult> res(n_regions);
+        for (RegionResult& r : res) r.region = growRegion(state, taken, size);
+        for (RegionResult& r : res)
+            for (int v : r.region) taken[v] = 0;
+
+        threads.run(n_regions, [&](int k) {
+            if (not res[k].region.empty()) solveRegion(state, res[k], local[k], seen[k]);
+        });
+
+        for (RegionResult& r : res) {
+            if (r.region.empty()) continue;
+            roundSolved++;
+            nodes += r.nodes;
+            if (r.optimal) roundProven++;
+            if (not r.improved) continue;
+            size_t mark = trail.size();
+            for (int v : r.region)
+                if (state.in[v]) state.remove(v);
+            for (int v : r.chosen) state.add(v);
+            if (state.feasible()) merged++;
+            else state.rollback(mark);
+        }
+        state.pruneAll();
+        trail.clear();
+        solved += roundSolved;
+        proven += roundProven;
+        if (2*roundProven > roundSolved) size = min(maxRegion, size + size/10 + 1);
+        else size = max(20, size - size/10 - 1);
+
+        if (state.size() < result) {
+            result = state.size();
+            time_stamp = timer.elapsed_time(clock);
+            cout << "value " << state.size() << "\ttime " << time_stamp << endl;
+        }
+    }
+    state.trail = nullptr;
+
+    double ct = timer.elapsed_time(clock);
+    cout << "rounds " << rounds << "\tregions " << solved << "\tproven optimal " << proven;
+    cout << "\tmerged " << merged << "\tregion size " << size;
+    cout << "\tnodes per second " << nodes/ct << endl;
+}
+
+
+/**********
+Main function
+**********/
+
+int main( int argc, char **argv ) {
+
+    read_parameters(argc,argv);
+
+    // setting the output format for doubles to 2 decimals after the comma
+    std::cout << std::setprecision(2) << std::fixed;
+
+    // initializing the random number generator. A random number
+    // between 0 and 1 is obtained with: double rnum = rnd->next();
+    rnd = new Random((unsigned) time(&t));
+    rnd->next();
+
+    // vectors for storing the result and the computation time
+    // obtained by the <n_apps> applications of the metaheuristic
+    vector<double> results(n_apps, std::numeric_limits<int>::max());
+    vector<double> times(n_apps, 0.0);
+
+    // opening the corresponding input file and reading the problem data
+    ifstream indata;
+    indata.open(inputFile.c_str());
+    if (not indata) { // file couldn't be opened
+        cout << "Error: file could not be opened" << endl;
+    }
+
+    indata >> n_of_nodes;
+    indata >> n_of_arcs;
+    neighbors = vector< unordered_set<int> >(n_of_nodes);
+    int u, v;
+    while (indata >> u >> v) {
+        neighbors[u - 1].insert(v - 1);
+        neighbors[v - 1].insert(u - 1);
+    }
+    indata.close();
+    graph = buildGraph(neighbors);
+
+    // certified lower bound from the LP relaxation
+    int lower_bound = lpLowerBound(graph, lb_iterations);
+
+    setNeighbor (neighbors);
+    unordered_set<int> start = greedy();
+
+    ThreadPool threads(n_threads);
+    // CPU time adds up over the threads, so use wall-clock time with several
+    Timer::TYPE clock = n_threads > 1 ? Timer::REAL : Timer::VIRTUAL;
+
+    // main loop over all applications of the metaheuristic
+    for (int na = 0; na < n_apps; ++na) {
+
+        // the computation time starts now
+        Timer timer;
+
+        cout << "start application " << na + 1 << endl;
+        cout << "greedy " << start.size() << endl;
+
+        PIDSState state;
+        state.init(graph);
+        state.load(start);
+        results[na] = state.size();
+        times[na] = timer.elapsed_time(clock);
+
+        largeNeighborhoodSearch(state, timer, clock, threads, results[na], times[na]);
+
+        if (not check_PIDS(state.toSet())) cout << "Error: solution is not a PIDS" << endl;
+
+        printGap(lower_bound, results[na]);
+        cout << "end application " << na + 1 << endl;
+    }
+
+    // calculating the average of the results and computation times,
+    // and their standard deviations, and write them to the screen
+    double r_mean = 0.0;
+    int r_best = std::numeric_limits<int>::max();
+    double t_mean = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        r_mean = r_mean + results[i];
+        if (int(results[i]) < r_best) r_best = int(results[i]);
+        t_mean = t_mean + times[i];
+    }
+    r_mean = r_mean/double(results.size());
+    t_mean = t_mean/double(times.size());
+    double rsd = 0.0;
+    double tsd = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        rsd = rsd + pow(results[i]-r_mean,2.0);
+        tsd = tsd + pow(times[i]-t_mean,2.0);
+    }
+    rsd = rsd/double(results.size());
+    if (rsd > 0.0) {
+        rsd = sqrt(rsd);
+    }
+    tsd = tsd/double(results.size());
+    if (tsd > 0.0) {
+        tsd = sqrt(tsd);
+    }
+    // printing statistical information
+    cout << r_best << "\t" << r_mean << "\t" << rsd << "\t";
+    cout << t_mean << "\t" << tsd << endl;
+}
@@ -0,0 +1,345 @@
+/***************************************************************************
+    memetic.cpp
+    (C) 2021 by C. Blum & M. Blesa
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Timer.h"
+#include "Random.h"
+#include "../Part_1/greedy_class.cpp"
+#include "pids_class.cpp"
+#include "tabu_class.cpp"
+#include "thread_class.cpp"
+#include "bound_class.cpp"
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <fstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <unordered_set>
+#include <limits>
+#include <iomanip>
+
+// global variables concerning the random number generator (in case needed)
+time_t t;
+Random* rnd;
+
+// Data structures for the problem data
+int n_of_nodes;
+int n_of_arcs;
+vector< unordered_set<int> > neighbors;
+Graph graph;
+
+// string for keeping the name of the input file
+string inputFile;
+
+// computing time limit for each application of the metaheuristic
+double time_limit = 600.0;
+
+// number of applications of the metaheuristic
+int n_apps = 1;
+
+// population size and offspring produced per generation
+int pop_size = 20;
+int n_offspring = 20;
+
+// tabu iterations applied to every new individual
+int64_t ls_iterations = 2000;
+
+// offspring closer than this Hamming distance to the population replace
+// their closest individual instead of the worst one
+int min_distance = 4;
+
+// threads used to build the offspring
+int n_threads = 1;
+
+// passes of the LP lower bound printed next to every result, 0 to skip it
+int lb_iterations = 500;
+
+
+void read_parameters(int argc, char **argv) {
+
+    int iarg = 1;
+    while (iarg < argc) {
+        if (strcmp(argv[iarg],"-i") == 0) inputFile = argv[++iarg];
+        // reading the computation time limit
+        // from the command line (if provided)
+        else if (strcmp(argv[iarg],"-t") == 0) time_limit = atoi(argv[++iarg]);
+        // reading the number of applications of the metaheuristic
+        // from the command line (if provided)
+        else if (strcmp(argv[iarg],"-n_apps") == 0) n_apps = atoi(argv[++iarg]);
+        // reading the parameters of the memetic algorithm
+        else if (strcmp(argv[iarg],"-pop") == 0) pop_size = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-offspring") == 0) n_offspring = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-ls") == 0) ls_iterations = atoll(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-dmin") == 0) min_distance = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-threads") == 0) n_threads = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-lb") == 0) lb_iterations = atoi(argv[++iarg]);
+        iarg++;
+    }
+}
+
+
+//////////////////////////////////////////////////////////////
+//                      INDIVIDUALS                         //
+//////////////////////////////////////////////////////////////
+
+// A PIDS stored as a bitset over the nodes
+struct Individual {
+    vector<uint64_t> bits;
+    int size = 0;
+};
+
+Individual fromState(const PIDSState& state) {
+    Individual ind;
+    ind.bits.assign((graph.n + 63)/64, 0);
+    for (int v : state.members) ind.bits[v >> 6] |= uint64_t(1) << (v & 63);
+    ind.size = state.size();
+    return ind;
+}
+
+vector<int> membersOf(const Individual& ind) {
+    vector<int> members;
+    for (int w = 0; w < int(ind.bits.size()); w++) {
+        for (uint64_t b = ind.bits[w]; b; b &= b - 1) members.push_back(64*w + __builtin_ctzll(b));
+    }
+    return members;
+}
+
+int hamming(const Individual& a, const Individual& b) {
+    int d = 0;
+    for (int w = 0; w < int(a.bits.size()); w++) d += __builtin_popcountll(a.bits[w] ^ b.bits[w]);
+    return d;
+}
+
+
+//////////////////////////////////////////////////////////////
+//                       OPERATORS                          //
+//////////////////////////////////////////////////////////////
+
+// Short tabu search from the given state, which ends at the best solution found
+void localSearch(PIDSState& state, Random* r) {
+    Timer timer;
+    int64_t tenure = 10 + graph.n/100;
+    TabuEngine tabu(state, r, tenure, tenure);
+    tabu.run(timer, numeric_limits<double>::max(), ls_iterations);
+}
+
+// Coverage-aware crossover: keep the members both parents share, add each
+// member of only one parent with probability 1/2, then repair and prune
+Individual crossover(const Individual& a, const Individual& b, Random* r) {
+    PIDSState state;
+    state.init(graph);
+    for (int w = 0; w < int(a.bits.size()); w++) {
+        uint64_t common = a.bits[w] & b.bits[w];
+        uint64_t other = a.bits[w] ^ b.bits[w];
+        for (uint64_t x = other; x; x &= x - 1) {
+            if (r->next() < 0.5) common |= x & -x;
+        }
+        for (; common; common &= common - 1) state.add(64*w + __builtin_ctzll(common));
+    }
+    state.repair();
+    state.pruneAll();
+    localSearch(state, r);
+    return fromState(state);
+}
+
+// Greedy solution with k random members removed, repaired and improved
+Individual mutant(const vector<int>& start, Random* r, int k) {
+    PIDSState state;
+    state.init(graph);
+    state.load(start);
+    for (int i = 0; i < k and state.size() > 0; i++)
+        state.remove(state.members[int(r->next()*state.size()) % state.size()]);
+    state.repair();
+    state.pruneAll();
+    localSearch(state, r);
+    return fromState(state);
+}
+
+int tournament(const vector<Individual>& pop, Random* r) {
+    int a = int(r->next()*pop.size()) % pop.size();
+    int b = int(r->next()*pop.size()) % pop.size();
+    return pop[a].size <= pop[b].size ? a : b;
+}
+
+// Insert child unless it is a duplicate. A child too close to the
+// population competes with its closest individual, otherwise with the worst
+bool insert(vector<Individual>& pop, const Individual& child) {
+    int closest = -1;
+    int closestDist = numeric_limits<int>::max();
+    int worst = 0;
+    for (int i = 0; i < int(pop.size()); i++) {
+        int d = hamming(pop[i], child);
+        if (d < closestDist) {
+            closest = i;
+            closestDist = d;
+        }
+        if (pop[i].size > pop[worst].size) worst = i;
+    }
+    if (closestDist == 0) return false;
+    int target = closestDist < min_distance ? closest : worst;
+    if (child.size > pop[target].size) return false;
+    pop[target] = child;
+    return true;
+}
+
+
+/**********
+Main function
+**********/
+
+int main( int argc, char **argv ) {
+
+    read_parameters(argc,argv);
+
+    // setting the output format for doubles to 2 decimals after the comma
+    std::cout << std::setprecision(2) << std::fixed;
+
+    // initializing the random number generator. A random number
+    // between 0 and 1 is obtained with: double rnum = rnd->next();
+    rnd = new Random((unsigned) time(&t));
+    rnd->next();
+
+    // vectors for storing the result and the computation time
+    // obtained by the <n_apps> applications of the metaheuristic
+    vector<double> results(n_apps, std::numeric_limits<int>::max());
+    vector<double> times(n_apps, 0.0);
+
+    // opening the corresponding input file and reading the problem data
+    ifstream indata;
+    indata.open(inputFile.c_str());
+    if (not indata) { // file couldn't be opened
+        cout << "Error: file could not be opened" << endl;
+    }
+
+    indata >> n_of_nodes;
+    indata >> n_of_arcs;
+    neighbors = vector< unordered_set<int> >(n_of_nodes);
+    int u, v;
+    while (indata >> u >> v) {
+        neighbors[u - 1].insert(v - 1);
+        neighbors[v - 1].insert(u - 1);
+    }
+    indata.close();
+    graph = buildGraph(neighbors);
+
+    // certified lower bound from the LP relaxation
+    int lower_bound = lpLowerBound(graph, lb_iterations);
+
+    setNeighbor (neighbors);
+    unordered_set<int> greedySolution = greedy();
+    vector<int> start(greedySolution.begin(), greedySolution.end());
+
+    ThreadPool threads(n_threads);
+    // CPU time adds up over the threads, so use wall-clock time with several
+    Timer::TYPE clock = n_threads > 1 ? Timer::REAL : Timer::VIRTUAL;
+
+    // main loop over all applications of the metaheuristic
+    for (int na = 0; na < n_apps; ++na) {
+
+        // the computation time starts now
+        Timer timer;
+
+        cout << "start application " << na + 1 << endl;
+        cout << "greedy " << start.size() << endl;
+
+        // every task gets its own generator so the result does not depend
+        // on how the tasks are spread over the threads
+        vector<Random> streams;
+        for (int i = 0; i < max(pop_size, n_offspring); i++)
+            streams.push_back(Random(int(rnd->next()*2147483646) + 1));
+
+        vector<Individual> pop(pop_size);
+        threads.run(pop_size, [&](int i) {
+            pop[i] = mutant(start, &streams[i], i == 0 ? 0 : 1 + int(start.size())/20);
+        });
+
+        Individual best = pop[0];
+        for (const Individual& ind : pop)
+            if (ind.size < best.size) best = ind;
+        results[na] = best.size;
+        times[na] = timer.elapsed_time(clock);
+        cout << "value " << best.size << "\ttime " << times[na] << endl;
+
+        long generation = 0;
+        vector<Individual> children(n_offspring);
+        while (timer.elapsed_time(clock) < time_limit) {
+            vector< pair<int,int> > parents(n_offspring);
+            for (int i = 0; i < n_offspring; i++)
+                parents[i] = make_pair(tournament(pop, rnd), tournament(pop, rnd));
+
+            threads.run(n_offspring, [&](int i) {
+                children[i] = crossover(pop[parents[i].first], pop[parents[i].second], &streams[i]);
+            });
+
+            for (const Individual& child : children) {
+                insert(pop, child);
+                if (child.size < best.size) {
+                    best = child;
+                    results[na] = best.size;
+                    times[na] = timer.elapsed_time(clock);
+                    cout << "value " << best.size << "\ttime " << times[na] << endl;
+                }
+            }
+            generation++;
+        }
+
+        unordered_set<int> solution;
+        for (int v : membersOf(best)) solution.insert(v);
+        cout << "generations " << generation << endl;
+        if (not check_PIDS(solution)) cout << "Error: solution is not a PIDS" << endl;
+
+        printGap(lower_bound, results[na]);
+        cout << "end application " << na + 1 << endl;
+    }
+
+    // calculating the average of the results and computation times,
+    // and their standard deviations, and write them to the screen
+    double r_mean = 0.0;
+    int r_best = std::numeric_limits<int>::max();
+    double t_mean = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        r_mean = r_mean + results[i];
+        if (int(results[i]) < r_best) r_best = int(results[i]);
+        t_mean = t_mean + times[i];
+    }
+    r_mean = r_mean/double(results.size());
+    t_mean = t_mean/double(times.size());
+    double rsd = 0.0;
+    double tsd = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        rsd = rsd + pow(results[i]-r_mean,2.0);
+        tsd = tsd + pow(times[i]-t_mean,2.0);
+    }
+    rsd = rsd/double(results.size());
+    if (rsd > 0.0) {
+        rsd = sqrt(rsd);
+    }
+    tsd = tsd/double(results.size());
+    if (tsd > 0.0) {
+        tsd = sqrt(tsd);
+    }
+    // printing statistical information
+    cout << r_best << "\t" << r_mean << "\t" << rsd << "\t";
+    cout << t_mean << "\t" << tsd << endl;
+}
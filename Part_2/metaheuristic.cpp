@@ -20,6 +20,11 @@
 #include "Timer.h"
 #include "Random.h"
 #include "../Part_1/greedy_class.cpp"
+#include "swap_class.cpp"
+#include "tabu_class.cpp"
+#include "thread_class.cpp"
+#include "elite_class.cpp"
+#include "bound_class.cpp"
 #include <vector>
 #include <string>
 #include <stdio.h>
@@ -39,31 +44,27 @@
 #include <climits>
 #include <iomanip>
 #include <float.h>
+#include <cstdint>
 
 // global variables concerning the random number generator (in case needed)
 time_t t;
 Random* rnd;
 
 // Data structures for the problem data
-struct hash_pair {
-    template <class T1, class T2>
-    size_t operator()(const pair<T1, T2>& p) const
-    {
-        auto hash1 = hash<T1>{}(p.first);
-        auto hash2 = hash<T2>{}(p.second);
-        return hash1 ^ hash2;
-    }
-};
-
 int n_of_nodes;
 int n_of_arcs;
 vector< unordered_set<int> > neighbors;
-unordered_map< pair<int,double>, long, hash_pair > tabuAdd; // <(i,j), k> means that add the node i to solution with score j is tabu for k steps
-unordered_map< pair<int,double>, long, hash_pair > tabuDelete; // <i, k> means that delete the node i to solution with score j is tabu for k steps
+vector<int64_t> tabuAdd;    // adding node i is tabu while the iteration is below tabuAdd[i]
+vector<int64_t> tabuDelete; // deleting node i is tabu while the iteration is below tabuDelete[i]
 unordered_set<int> globalMinimum;
 double scoreGlobalMinimum;
 vector<int> neighbors_popularity;
 double percentage;
+Graph graph;
+int64_t tabu_iterations;
+double time_best;
+vector<char> in_solution;
+vector<double> coverage_weight; // increase of percentage when adding a node
 
 
 // string for keeping the name of the input file
@@ -75,6 +76,34 @@ double time_limit = 600.0;
 // number of applications of the metaheuristic
 int n_apps = 1;
 
+// number of plateau swaps applied to the greedy solution before
+// tabu search, -1 to skip the swap phase
+long swap_moves = -1;
+
+// tabu tenures after deleting (tenure_add) and adding (tenure_delete) a
+// node, -1 to use the number of nodes (10 + n/100 for the incremental engine)
+int64_t tenure_add = -1;
+int64_t tenure_delete = -1;
+
+// 1 to use the incremental tabu engine instead of tabuSearch
+int incremental = 0;
+
+// threads used to evaluate the moves of tabuSearch
+int n_threads = 1;
+
+// if positive, time this many tabuSearch iterations with 1..16 threads
+int64_t bench_threads = 0;
+
+// number of cooperative tabu workers, 0 to run a single search
+int coop_workers = 0;
+
+// iterations without improvement before a cooperative worker restarts
+// from a perturbed elite solution
+int64_t stagnation = 100000;
+
+// passes of the LP lower bound printed next to every result, 0 to skip it
+int lb_iterations = 500;
+
 // dummy parameters as examples for creating command line parameters 
 // (see function read_parameters(...))
 int dummy_integer_parameter = 0;
@@ -102,6 +131,20 @@ void read_parameters(int argc, char **argv) {
         // reading the number of applications of the metaheuristic 
         // from the command line (if provided)
         else if (strcmp(argv[iarg],"-n_apps") == 0) n_apps = atoi(argv[++iarg]); 
+        // reading the number of plateau swaps done after greedy
+        else if (strcmp(argv[iarg],"-swaps") == 0) swap_moves = atol(argv[++iarg]);
+        // reading the tabu tenures
+        else if (strcmp(argv[iarg],"-tenure_add") == 0) tenure_add = atoll(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-tenure_delete") == 0) tenure_delete = atoll(argv[++iarg]);
+        // choosing the tabu engine
+        else if (strcmp(argv[iarg],"-incremental") == 0) incremental = atoi(argv[++iarg]);
+        // reading the number of threads and the thread benchmark
+        else if (strcmp(argv[iarg],"-threads") == 0) n_threads = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-bench_threads") == 0) bench_threads = atoll(argv[++iarg]);
+        // reading the cooperative search parameters
+        else if (strcmp(argv[iarg],"-coop") == 0) coop_workers = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-stagnation") == 0) stagnation = atoll(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-lb") == 0) lb_iterations = atoi(argv[++iarg]);
         // example for creating a command line parameter 
         // param1 -> integer value is stored in dummy_integer_parameter
         else if (strcmp(argv[iarg],"-param1") == 0) {
@@ -141,9 +184,9 @@ void compute_percentage_neighbors(const unordered_set<int> &solution) {
 
 
 //Return if a node can be deleted in the solution
-bool canDelete(int node, unordered_set<int> &solution) {
-    for (int neighbor : neighbors[node]) {
-        if ((neighbors_popularity[neighbor] - 1.f) < neighbors[neighbor].size()/2.f) {
+bool canDelete(int node) {
+    for (const int* neighbor = graph.begin(node); neighbor != graph.end(node); ++neighbor) {
+        if ((neighbors_popularity[*neighbor] - 1.f) < graph.degree(*neighbor)/2.f) {
             return false;
         }
     }
@@ -157,8 +200,8 @@ bool canDelete(int node, unordered_set<int> &solution) {
 
 
 //Heuristic used to find the best solution
-double computeHeuristic(const unordered_set<int>& solution, int score) {
-    return 1000*solution.size() + score;
+double computeHeuristic(int size, int score) {
+    return 1000*size + score;
 }
 
 //////////////////////////////////////////////////////////////
@@ -168,6 +211,7 @@ double computeHeuristic(const unordered_set<int>& solution, int score) {
 //Operator to add a nodes
 double addNode(unordered_set<int>& solution, int node) {
     solution.insert(node);
+    in_solution[node] = 1;
     double percentage_aux = percentage;
     for (int neighbor : neighbors[node]) {
         neighbors_popularity[neighbor]++;
@@ -179,6 +223,7 @@ double addNode(unordered_set<int>& solution, int node) {
 //Operetor to delete a node
 double deleteNode(unordered_set<int>& solution, int node) {
     solution.erase(node);
+    in_solution[node] = 0;
     double percentage_aux = percentage;
     for (int neighbor : neighbors[node]) {
         neighbors_popularity[neighbor]--;
@@ -192,97 +237,197 @@ double deleteNode(unordered_set<int>& solution, int node) {
 //                    TABU SERACH                           //
 //////////////////////////////////////////////////////////////
 
-//Tabu Search
-void tabuSearch(unordered_set<int> solution, Timer timer) {
-    int it = 0;
-    long itInTabu = neighbors.size();
-    double scoreLocalMinimum;
-    unordered_set<int> localBestSolution;
-    for (int i = 0; i < neighbors.size(); i++) 
-        localBestSolution.insert(i);
-
-    vector<int> neighbors_popularity_min = neighbors_popularity;
-
-    while (timer.elapsed_time(Timer::VIRTUAL) <= time_limit) {
-        int nd = -1;
-        bool add = false;
-        bool del = false;
-
-        scoreLocalMinimum = DBL_MAX-neighbors.size();
-        //Loop to add nodes
-        for (int node = 0; node < neighbors.size(); node++) {
-            if (solution.find(node) == solution.end()) {
-                double percentage_aux = addNode(solution, node);
-                double currHeuristicVal = computeHeuristic(solution,percentage_aux);
-                if (tabuAdd[{node, 0}] <= it || currHeuristicVal < computeHeuristic(globalMinimum,scoreGlobalMinimum)) {
-                    if (currHeuristicVal < computeHeuristic(localBestSolution,scoreLocalMinimum)) {
-                        scoreLocalMinimum = percentage_aux;
-                        localBestSolution = solution;
-                        neighbors_popularity_min = neighbors_popularity;
-                        add = true;
-                        del = false;
-                        nd = node;
-                    }
-                }
-                for (int neighbor : neighbors[node]) {
-                    neighbors_popularity[neighbor]--;
-                }
-                solution.erase(node);
-            }
+struct Move {
+    double value = DBL_MAX;
+    int node = -1;
+    bool del = false;
+};
+
+//Order of the moves: lower heuristic, then adds before deletes, then lower node
+bool betterMove(const Move& a, const Move& b) {
+    if (a.value != b.value) return a.value < b.value;
+    if (a.del != b.del) return not a.del;
+    return a.node < b.node;
+}
+
+//Best admissible move among the nodes in [lo, hi). It only reads the
+//solution and neighbors_popularity, so ranges can be evaluated in parallel
+Move evaluateMoves(int lo, int hi, int size, int64_t it, double globalValue) {
+    Move best;
+    for (int node = lo; node < hi; node++) {
+        Move m;
+        m.node = node;
+        if (not in_solution[node]) {
+            m.value = computeHeuristic(size + 1, percentage + coverage_weight[node]);
+            if (tabuAdd[node] > it and m.value >= globalValue) continue;
+        }
+        else if (canDelete(node)) {
+            m.del = true;
+            m.value = computeHeuristic(size - 1, percentage - coverage_weight[node]);
+            if (tabuDelete[node] > it and m.value >= globalValue) continue;
         }
+        else continue;
+        if (betterMove(m, best)) best = m;
+    }
+    return best;
+}
 
-        //Loop to delete nodes
-        for (int node = 0; node < neighbors.size(); node++) {
-            if (solution.find(node) != solution.end()) { 
-                if (canDelete(node, solution)) {
-                    double percentage_aux = deleteNode(solution, node);
-                    double currHeuristicVal = computeHeuristic(solution,percentage_aux);
-                    
-                    if (tabuAdd[{node, percentage_aux}] <= it or currHeuristicVal < computeHeuristic(globalMinimum,scoreGlobalMinimum)) {
-                        if (computeHeuristic(solution,percentage_aux) < computeHeuristic(localBestSolution,scoreLocalMinimum)) {
-                            scoreLocalMinimum = percentage_aux;
-                            localBestSolution = solution;
-                            neighbors_popularity_min = neighbors_popularity;
-                            del = true;
-                            add = false;
-                            nd = node;
-                        }   
-                    }
-                    for (int neighbor : neighbors[node]) {
-                        neighbors_popularity[neighbor]++;
-                    }
-                    solution.insert(node);
-                }
+//Tabu Search. Every iteration scores all add and delete moves, split in
+//n_threads ranges, and applies the best one. It stops at limit seconds or
+//after max_iterations iterations and reports new minima to log
+void tabuSearch(unordered_set<int> solution, Timer& timer, ThreadPool& pool, double limit, ostream& log,
+                int64_t max_iterations = -1) {
+    int64_t& it = tabu_iterations;
+    it = 0;
+    int64_t addTenure = tenure_add >= 0 ? tenure_add : neighbors.size();
+    int64_t deleteTenure = tenure_delete >= 0 ? tenure_delete : neighbors.size();
+    tabuAdd.assign(neighbors.size(), 0);
+    tabuDelete.assign(neighbors.size(), 0);
+    in_solution.assign(neighbors.size(), 0);
+    for (int node : solution) in_solution[node] = 1;
+    coverage_weight.assign(neighbors.size(), 0.0);
+    for (size_t node = 0; node < neighbors.size(); node++)
+        for (int neighbor : neighbors[node]) coverage_weight[node] += 1.0 / neighbors[neighbor].size();
+
+    // CPU time adds up over the threads, so use wall-clock time with several
+    Timer::TYPE clock = pool.n_threads > 1 ? Timer::REAL : Timer::VIRTUAL;
+    int n_ranges = pool.n_threads;
+    vector<Move> bestInRange(n_ranges);
+
+    while (timer.elapsed_time(clock) <= limit and (max_iterations < 0 or it < max_iterations)) {
+        double globalValue = computeHeuristic(globalMinimum.size(), scoreGlobalMinimum);
+        int size = solution.size();
+        int n = neighbors.size();
+        pool.run(n_ranges, [&](int r) {
+            bestInRange[r] = evaluateMoves(long(n)*r/n_ranges, long(n)*(r + 1)/n_ranges, size, it, globalValue);
+        });
+        Move best;
+        for (const Move& m : bestInRange)
+            if (betterMove(m, best)) best = m;
+
+        if (best.node != -1) {
+            if (best.del) {
+                percentage = deleteNode(solution, best.node);
+                tabuAdd[best.node] = it + addTenure;
+            }
+            else {
+                percentage = addNode(solution, best.node);
+                tabuDelete[best.node] = it + deleteTenure;
+            }
+            if (computeHeuristic(solution.size(), percentage) < globalValue) {
+                scoreGlobalMinimum = percentage;
+                globalMinimum = solution;
+                time_best = timer.elapsed_time(clock);
+                log << "New global minimum: " << globalMinimum.size()<< endl;
             }
         }
+        it++;
+    }
+}
 
-        if (LONG_MAX - itInTabu <= (long) it) {
-            tabuAdd.clear();
-            tabuDelete.clear();
-            it = 0;
-            cout << "Big num" << endl;
-        }
+//Run the same number of iterations from the same solution with 1, 2, 4,
+//8 and 16 threads and report the speedup over one thread
+void benchmarkThreads(const unordered_set<int>& start, int64_t iterations) {
+    double baseTime = 0.0;
+    ostream silent(nullptr);
+    vector<int> startPopularity = neighbors_popularity;
+    double startPercentage = percentage;
+    for (int threads = 1; threads <= 16; threads *= 2) {
+        neighbors_popularity = startPopularity;
+        percentage = startPercentage;
+        globalMinimum = start;
+        scoreGlobalMinimum = startPercentage;
+        ThreadPool pool(threads);
+        Timer timer;
+        tabuSearch(start, timer, pool, DBL_MAX, silent, iterations);
+        double ct = timer.elapsed_time(Timer::REAL);
+        if (threads == 1) baseTime = ct;
+        cout << "threads " << threads << "\ttime " << ct << "\tspeedup " << baseTime/ct;
+        cout << "\tnodes " << globalMinimum.size() << endl;
+    }
+}
 
-        if (computeHeuristic(solution,scoreLocalMinimum) < computeHeuristic(globalMinimum,scoreGlobalMinimum)) {
-            scoreGlobalMinimum = scoreLocalMinimum;
-            globalMinimum = localBestSolution;
-            neighbors_popularity = neighbors_popularity_min;
-            cout << "New global minimum: " << globalMinimum.size()<< endl;
-        }
+//////////////////////////////////////////////////////////////
+//                COOPERATIVE TABU SEARCH                   //
+//////////////////////////////////////////////////////////////
 
-        if (nd != -1) {
-            solution = localBestSolution;
-            percentage = scoreLocalMinimum;
-            neighbors_popularity = neighbors_popularity_min;
-            if (del) tabuAdd[{nd, 0}] = itInTabu + it;
-            
-            else if (add) tabuAdd[{nd, 0}] = itInTabu + it;
+//Remove k random members and make the solution feasible again
+void perturb(PIDSState& state, Random* r, int k) {
+    for (int i = 0; i < k and state.size() > 0; i++)
+        state.remove(state.members[int(r->next()*state.size()) % state.size()]);
+    state.repair();
+    state.pruneAll();
+}
+
+//Run n_workers incremental tabu searches with their own seed and tenure.
+//Improvements go to a shared elite pool; a worker that does not improve
+//for <stagnation> iterations restarts from a perturbed elite solution.
+void cooperativeSearch(const unordered_set<int>& start, Timer& timer, int n_workers) {
+    // Timer is not safe to share, so every worker reads its own clock,
+    // started here <offset> seconds into the application
+    double offset = timer.elapsed_time(Timer::REAL);
+    vector<Timer> clocks(n_workers);
+    ElitePool pool(2*n_workers);
+    pool.push(vector<int>(start.begin(), start.end()), -1, offset);
+    int64_t baseTenure = tenure_add >= 0 ? tenure_add : 10 + graph.n/100;
+    vector<int64_t> iterations(n_workers, 0);
+    vector<int> restarts(n_workers, 0);
+    vector<int> improvements(n_workers, 0);
+    // fresh seeds from the main generator in every application
+    vector<Random> streams;
+    for (int w = 0; w < n_workers; w++) streams.push_back(Random(int(rnd->next()*2147483646) + 1));
+
+    auto worker = [&](int w) {
+        Random& r = streams[w];
+        auto now = [&]() { return offset + clocks[w].elapsed_time(Timer::REAL); };
+        int64_t tenure = baseTenure/2 + baseTenure*w/max(1, n_workers - 1);
+        PIDSState state;
+        state.init(graph);
+        state.load(start);
+        if (w > 0) perturb(state, &r, 1 + state.size()/50);
+
+        while (now() <= time_limit) {
+            TabuEngine tabu(state, &r, tenure, tenure);
+            int64_t lastImprovement = 0;
+            tabu.onImprove = [&](int value) {
+                lastImprovement = tabu.it;
+                if (value < pool.bestSize() and
+                    pool.push(state.members, w, now())) improvements[w]++;
+            };
+            while (tabu.it - lastImprovement < stagnation) {
+                if ((tabu.it & 255) == 0 and now() > time_limit) break;
+                if (not tabu.step()) break;
+            }
+            iterations[w] += tabu.it;
+            if (now() > time_limit) break;
+
+            // restart from a perturbed elite solution
+            vector<int> elite;
+            pool.sample(&r, elite);
+            state.load(elite);
+            perturb(state, &r, 1 + state.size()/50);
+            restarts[w]++;
         }
-        it++;
+    };
+
+    vector<thread> threads;
+    for (int w = 0; w < n_workers; w++) threads.push_back(thread(worker, w));
+    for (thread& t : threads) t.join();
+
+    vector<int> best;
+    pool.copyBest(best);
+    globalMinimum = unordered_set<int>(best.begin(), best.end());
+    tabu_iterations = 0;
+    for (int w = 0; w < n_workers; w++) {
+        tabu_iterations += iterations[w];
+        cout << "worker " << w << "\titerations " << iterations[w] << "\trestarts " << restarts[w];
+        cout << "\timprovements " << improvements[w] << endl;
     }
 
-    for (pair <pair <int, int>, long> px : tabuAdd){
-        cout << px.first.first << " " << px.first.second << ": " << px.second << endl;
+    // time-to-target trace
+    for (const ElitePool::TracePoint& p : pool.timeline()) {
+        cout << "value " << p.size << "\ttime " << p.time << "\tworker " << p.worker << endl;
+        time_best = p.time;
     }
 }
 
@@ -323,6 +468,10 @@ int main( int argc, char **argv ) {
         neighbors[v - 1].insert(u - 1);
     }
     indata.close();
+    graph = buildGraph(neighbors);
+
+    // certified lower bound from the LP relaxation
+    int lower_bound = lpLowerBound(graph, lb_iterations);
 
     // main loop over all applications of the metaheuristic
     for (int na = 0; na < n_apps; ++na) {
@@ -340,14 +489,53 @@ int main( int argc, char **argv ) {
         setNeighbor (neighbors);
         unordered_set <int> sAux = greedy();
         sAux = remove_nodes(sAux);
-        globalMinimum = sAux;
         neighbors_popularity = getNeighborPopularity();
-        compute_percentage_neighbors(sAux);
         cout << "Nodes greedy: " << sAux.size() << endl;
+        if (swap_moves >= 0) {
+            PIDSState state;
+            state.init(graph);
+            state.load(sAux);
+            SwapEngine swaps(state, rnd);
+            swaps.run(swap_moves);
+            sAux = state.toSet();
+            neighbors_popularity = state.popularity;
+            cout << "Nodes swaps: " << sAux.size() << "\t(k,1) " << swaps.kSwaps;
+            cout << "\t(1,1) " << swaps.plateauSwaps << endl;
+        }
+        globalMinimum = sAux;
+        compute_percentage_neighbors(sAux);
+        time_best = timer.elapsed_time(Timer::VIRTUAL);
+
+        if (incremental) {
+            PIDSState state;
+            state.init(graph);
+            state.load(sAux);
+            int64_t tenure = 10 + graph.n/100;
+            TabuEngine tabu(state, rnd, tenure_add >= 0 ? tenure_add : tenure,
+                            tenure_delete >= 0 ? tenure_delete : tenure);
+            tabu.onImprove = [&](int value) {
+                time_best = timer.elapsed_time(Timer::VIRTUAL);
+                cout << "value " << value << "\ttime " << time_best << endl;
+            };
+            tabu.run(timer, time_limit);
+            tabu_iterations = tabu.it;
+            globalMinimum = state.toSet();
+        }
+        else if (coop_workers > 0) cooperativeSearch(sAux, timer, coop_workers);
+        else if (bench_threads > 0) {
+            benchmarkThreads(sAux, bench_threads);
+            tabu_iterations = 0;
+        }
+        else {
+            ThreadPool pool(n_threads);
+            tabuSearch(sAux, timer, pool, time_limit, cout);
+        }
 
-        tabuSearch(sAux, timer);
-
+        double ct = timer.elapsed_time(Timer::VIRTUAL);
+        results[na] = globalMinimum.size();
+        times[na] = time_best;
         cout << "Number of nodes: " << globalMinimum.size() << endl;
+        cout << "iterations " << tabu_iterations << "\tper second " << tabu_iterations/ct << endl;
 
         if (check_PIDS(globalMinimum)) cout << "YEEEEEES" << endl;
 
@@ -371,6 +559,7 @@ int main( int argc, char **argv ) {
         // Stop the execution of the metaheuristic 
         // once the time limit "time_limit" is reached.
 
+        printGap(lower_bound, results[na]);
         cout << "end application " << na + 1 << endl;
     }
 
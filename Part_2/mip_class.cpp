@@ -0,0 +1,269 @@
+#ifndef MIP_CLASS_CPP
+#define MIP_CLASS_CPP
+
+#include "Timer.h"
+#include "cover_class.cpp"
+#include <vector>
+#include <string>
+#include <functional>
+#include <memory>
+#include <cmath>
+#include <climits>
+#include <limits>
+
+#ifdef HAVE_CPLEX
+#include <ilcplex/ilocplex.h>
+#endif
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////
+//                       MIP MODEL                          //
+//////////////////////////////////////////////////////////////
+
+// Solver-independent model: min obj x over binary x subject to
+// sparse rows sum coef[k] x[col[k]] >= rhs
+struct MIPModel {
+    int n_vars = 0;
+    vector<double> obj;
+    vector<int> rowStart = vector<int>(1, 0);
+    vector<int> rowCol;
+    vector<double> rowCoef;
+    vector<double> rhs;
+
+    int addVar(double cost) {
+        obj.push_back(cost);
+        return n_vars++;
+    }
+
+    void addRow(const vector<int>& cols, const vector<double>& coefs, double b) {
+        rowCol.insert(rowCol.end(), cols.begin(), cols.end());
+        rowCoef.insert(rowCoef.end(), coefs.begin(), coefs.end());
+        rowStart.push_back(rowCol.size());
+        rhs.push_back(b);
+    }
+
+    int n_rows() const { return rhs.size(); }
+};
+
+struct MIPParams {
+    int threads = 1;
+    double time_limit = 3200.0;
+    double gap = 0.0; // relative optimality gap at which to stop
+    // only solutions of value at most cutoff are searched for
+    double cutoff = numeric_limits<double>::max();
+    // a lower bound on the optimum known from elsewhere, 0 for none
+    double lowerBound = 0.0;
+    // a feasible solution to start from, one value per variable (empty
+    // for none); ignored if it is not feasible or above the cutoff
+    vector<double> start;
+
+    // called with the value and the gap (in %) of every new incumbent
+    function<void(double, double)> onIncumbent;
+};
+
+struct MIPResult {
+    bool feasible = false;
+    bool optimal = false; // the search completed: optimal, or proven infeasible
+
+    double value = 0.0;
+    double gap = 100.0; // in %
+    long nodes = 0;
+    vector<double> x;
+    string message;
+};
+
+struct MIPBackend {
+    virtual ~MIPBackend() {}
+    virtual string name() const = 0;
+    // Returns false if the backend could not handle the model
+    virtual bool solve(const MIPModel& model, const MIPParams& params, MIPResult& result) = 0;
+};
+
+
+//////////////////////////////////////////////////////////////
+//                    NATIVE BACKEND                        //
+//////////////////////////////////////////////////////////////
+
+// CoverSolver branch and bound. It takes covering models only: integer
+// costs and coefficients, no negative coefficient. It runs on one thread
+// and rejects more; mip_mpids hands those runs to the parallel ExactSolver
+struct NativeBackend : MIPBackend {
+    string name() const { return "native"; }
+
+    bool solve(const MIPModel& model, const MIPParams& params, MIPResult& result) {
+        if (params.threads > 1) {
+            result.message = "the native backend runs on one thread";
+            return false;
+        }
+        CoverInstance inst(model.n_vars);
+        for (int j = 0; j < model.n_vars; j++) {
+            if (model.obj[j] <= 0.0 or model.obj[j] != floor(model.obj[j])) {
+                result.message = "the native backend needs positive integer costs";
+                return false;
+            }
+            inst.cost[j] = int(model.obj[j]);
+        }
+        vector<int> cols;
+        vector<int> coefs;
+        for (int i = 0; i < model.n_rows(); i++) {
+            cols.clear();
+            coefs.clear();
+            for (int k = model.rowStart[i]; k < model.rowStart[i + 1]; k++) {
+                double a = model.rowCoef[k];
+                if (a < 0.0 or a != floor(a)) {
+                    result.message = "the native backend needs non-negative integer coefficients";
+                    return false;
+                }
+                if (a == 0.0) continue;
+                cols.push_back(model.rowCol[k]);
+                coefs.push_back(int(a));
+            }
+            inst.addRow(cols, coefs, int(ceil(model.rhs[i] - 1e-9)));
+        }
+        inst.build();
+
+        // the start is the first incumbent if it is feasible within the cutoff
+        int startCost = INT_MAX;
+        if (int(params.start.size()) == model.n_vars) {
+            bool feasible = true;
+            for (int i = 0; i < model.n_rows() and feasible; i++) {
+                double lhs = 0.0;
+                for (int k = model.rowStart[i]; k < model.rowStart[i + 1]; k++)
+                    lhs += model.rowCoef[k]*params.start[model.rowCol[k]];
+                feasible = lhs >= model.rhs[i] - 1e-9;
+            }
+            double cost = 0.0;
+            for (int j = 0; j < model.n_vars; j++) cost += model.obj[j]*params.start[j];
+            if (feasible and cost <= params.cutoff + 1e-9) startCost = int(floor(cost + 0.5));
+        }
+
+        CoverSolver solver(inst, -1, params.time_limit);
+        solver.gap = params.gap;
+        solver.lowerBound = max(0, int(ceil(params.lowerBound - 1e-9)));
+        if (params.onIncumbent) {
+            solver.onImprove = [&](int cost) {
+                params.onIncumbent(cost, 100.0*(cost - solver.rootBound)/max(cost, 1));
+            };
+        }
+        int upper = params.cutoff < INT_MAX ? int(floor(params.cutoff + 1e-9)) + 1 : INT_MAX;
+        upper = min(upper, startCost);
+        bool found = solver.solve(upper);
+        result.nodes = solver.nodes;
+        result.optimal = solver.optimal;
+        if (found) {
+            result.value = solver.bestCost;
+            result.x.assign(solver.solution.begin(), solver.solution.end());
+        }
+        else if (startCost < INT_MAX) {
+            result.value = startCost;
+            result.x = params.start;
+        }
+        else return true;
+        result.feasible = true;
+        int bound = max(solver.rootBound, solver.lowerBound);
+        result.gap = result.optimal ? 0.0 : 100.0*(result.value - bound)/max(result.value, 1.0);
+        return true;
+    }
+};
+
+
+#ifdef HAVE_CPLEX
+//////////////////////////////////////////////////////////////
+//                     CPLEX BACKEND                        //
+//////////////////////////////////////////////////////////////
+
+ILOSTLBEGIN
+
+ILOSOLVECALLBACK2(mipLoggingCallback,
+                  const MIPParams&, params,
+                  double&, result) {
+    if (hasIncumbent()) {
+        double nv = getIncumbentObjValue();
+        if (result > nv) {
+            result = nv;
+            params.onIncumbent(nv, 100.0*getMIPRelativeGap());
+        }
+    }
+}
+
+struct CplexBackend : MIPBackend {
+    string name() const { return "cplex"; }
+
+    bool solve(const MIPModel& model, const MIPParams& params, MIPResult& result) {
+        IloEnv env;
+        env.setOut(env.getNullStream());
+        try {
+            IloModel cmodel(env);
+            IloNumVarArray x(env, model.n_vars, 0, 1, ILOINT);
+            IloExpr obj(env);
+            for (int j = 0; j < model.n_vars; j++) obj += model.obj[j]*x[j];
+            cmodel.add(IloMinimize(env, obj));
+            obj.end();
+            for (int i = 0; i < model.n_rows(); i++) {
+                IloExpr expr(env);
+                for (int k = model.rowStart[i]; k < model.rowStart[i + 1]; k++)
+                    expr += model.rowCoef[k]*x[model.rowCol[k]];
+                cmodel.add(expr >= model.rhs[i]);
+                expr.end();
+            }
+
+            IloCplex cpl(cmodel);
+            cpl.setParam(IloCplex::TiLim, params.time_limit);
+            cpl.setParam(IloCplex::EpGap, params.gap);
+            cpl.setParam(IloCplex::EpAGap, 0.0);
+            cpl.setParam(IloCplex::Threads, params.threads);
+            if (params.cutoff < IloInfinity) cpl.setParam(IloCplex::CutUp, params.cutoff);
+            cpl.setWarning(env.getNullStream());
+            double incumbent = numeric_limits<double>::max();
+            if (params.onIncumbent) cpl.use(mipLoggingCallback(env, params, incumbent));
+            if (int(params.start.size()) == model.n_vars) {
+                IloNumArray startVal(env);
+                for (int j = 0; j < model.n_vars; j++) startVal.add(params.start[j]);
+                cpl.addMIPStart(x, startVal, IloCplex::MIPStartCheckFeas);
+                startVal.end();
+            }
+            cpl.solve();
+
+            result.nodes = cpl.getNnodes();
+            result.optimal = cpl.getStatus() == IloAlgorithm::Infeasible;
+            if (cpl.getStatus() == IloAlgorithm::Optimal or cpl.getStatus() == IloAlgorithm::Feasible) {
+                result.feasible = true;
+                result.optimal = cpl.getStatus() == IloAlgorithm::Optimal;
+                result.value = cpl.getObjValue();
+                result.gap = fabs(100.0*cpl.getMIPRelativeGap());
+                result.x.resize(model.n_vars);
+                for (int j = 0; j < model.n_vars; j++) result.x[j] = cpl.getValue(x[j]);
+            }
+        }
+        catch (IloException& e) {
+            result.message = e.getMessage();
+            env.end();
+            return false;
+        }
+        env.end();
+        return true;
+    }
+};
+#endif
+
+
+// Backend by name, nullptr if it was not compiled in
+unique_ptr<MIPBackend> makeBackend(const string& name) {
+    if (name == "native") return unique_ptr<MIPBackend>(new NativeBackend());
+#ifdef HAVE_CPLEX
+    if (name == "cplex") return unique_ptr<MIPBackend>(new CplexBackend());
+#endif
+    return nullptr;
+}
+
+// The best backend available in this build
+string defaultBackend() {
+#ifdef HAVE_CPLEX
+    return "cplex";
+#else
+    return "native";
+#endif
+}
+
+#endif
@@ -0,0 +1,336 @@
+/***************************************************************************
+    mip_mpids.cpp
+    (C) 2021 by C. Blum & M. Blesa
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Timer.h"
+#include "Random.h"
+#include "../Part_1/greedy_class.cpp"
+#include "tabu_class.cpp"
+#include "mip_class.cpp"
+#include "bound_class.cpp"
+#include "symmetry_class.cpp"
+#include "exact_class.cpp"
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <fstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include <limits>
+#include <iomanip>
+
+// global variables concerning the random number generator (in case needed)
+time_t t;
+Random* rnd;
+
+// Data structures for the problem data
+int n_of_nodes;
+int n_of_arcs;
+vector< unordered_set<int> > neighbors;
+
+// string for keeping the name of the input file
+string inputFile;
+
+// solver to use: native or cplex (the best one compiled in by default)
+string backend = defaultBackend();
+
+// time limit, relative gap and threads given to the solver
+double time_limit = 3200.0;
+
+// number of applications
+int n_apps = 1;
+double gap = 0.0;
+int n_threads = 1;
+
+// 1 to fix variables by LP reduced cost before the model is handed to the
+// solver, against the greedy solution improved by <tabu_iterations> of tabu
+int reduce = 0;
+int64_t tabu_iterations = 20000;
+
+// 1 to order every class of twins with rows x[u] - x[v] >= 0 (not taken
+// by the native backend, which needs non-negative coefficients)
+int symmetry = 0;
+
+
+void read_parameters(int argc, char **argv) {
+
+    int iarg = 1;
+    while (iarg < argc) {
+        if (strcmp(argv[iarg],"-i") == 0) inputFile = argv[++iarg];
+        else if (strcmp(argv[iarg],"-t") == 0) time_limit = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-n_apps") == 0) n_apps = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-gap") == 0) gap = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-threads") == 0) n_threads = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-backend") == 0) backend = argv[++iarg];
+        else if (strcmp(argv[iarg],"-fix") == 0) reduce = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-tabu") == 0) tabu_iterations = atoll(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-sym") == 0) symmetry = atoi(argv[++iarg]);
+        iarg++;
+    }
+}
+
+// One binary variable per node and one row per node: at least
+// ceil(deg(v)/2) of the neighbors of v are in the solution. Nodes with
+// fixed[v] >= 0 get no variable: var[v] is the variable of v or -1
+MIPModel buildModel(const vector<int>& fixed, vector<int>& var) {
+    MIPModel model;
+    var.assign(n_of_nodes, -1);
+    for (int i = 0; i < n_of_nodes; ++i)
+        if (fixed[i] < 0) var[i] = model.addVar(1.0);
+    for (int i = 0; i < n_of_nodes; ++i) {
+        vector<int> cols;
+        int need = (neighbors[i].size() + 1)/2;
+        for (int j : neighbors[i]) {
+            if (fixed[j] == 1) need--;
+            else if (fixed[j] < 0) cols.push_back(var[j]);
+        }
+        if (need > 0) model.addRow(cols, vector<double>(cols.size(), 1.0), need);
+    }
+    return model;
+}
+
+
+// Main function
+
+int main( int argc, char **argv ) {
+
+    read_parameters(argc,argv);
+
+    // setting the output format for doubles to 2 decimals after the comma
+    std::cout << std::setprecision(2) << std::fixed;
+
+    rnd = new Random((unsigned) time(&t));
+    rnd->next();
+
+    // opening the corresponding input file and reading the problem data
+    ifstream indata;
+    indata.open(inputFile.c_str());
+    if (not indata) { // file couldn't be opened
+        cout << "Error: file could not be opened" << endl;
+    }
+
+    indata >> n_of_nodes;
+    indata >> n_of_arcs;
+    neighbors = vector< unordered_set<int> >(n_of_nodes);
+    int u, v;
+    while (indata >> u >> v) {
+        neighbors[u - 1].insert(v - 1);
+        neighbors[v - 1].insert(u - 1);
+    }
+    indata.close();
+
+    unique_ptr<MIPBackend> solver = makeBackend(backend);
+    if (not solver) {
+        cout << "Error: backend " << backend << " is not available in this build" << endl;
+        return 1;
+    }
+
+    // vectors for storing the result and the computation time
+    // obtained by the <n_apps> applications
+    vector<double> results(n_apps, std::numeric_limits<int>::max());
+    vector<double> times(n_apps, 0.0);
+
+    // main loop over all applications
+    for (int na = 0; na < n_apps; ++na) {
+
+        // the computation time starts now
+        Timer timer;
+
+        cout << "start application " << na + 1 << endl;
+
+        // CPU time adds up over the threads, so use wall-clock time with several
+        Timer::TYPE clock = n_threads > 1 ? Timer::REAL : Timer::VIRTUAL;
+
+        // the heuristic solution is the start of every backend and the LP
+        // bound its lower bound; reduced-cost fixing keeps only the
+        // solutions smaller than the heuristic one
+        Graph graph = buildGraph(neighbors);
+        setNeighbor (neighbors);
+        unordered_set<int> greedySolution = greedy();
+        PIDSState state;
+        state.init(graph);
+        state.load(greedySolution);
+        int64_t tenure = 10 + graph.n/100;
+        TabuEngine tabu(state, rnd, tenure, tenure);
+        tabu.run(timer, numeric_limits<double>::max(), tabu_iterations);
+        vector<int> heuristic = state.members;
+        results[na] = heuristic.size();
+        times[na] = timer.elapsed_time(clock);
+        cout << "value " << heuristic.size() << "\ttime " << times[na] << endl;
+        LPBound lp(graph);
+        lp.run(500);
+        int lower_bound = lp.integerBound();
+        vector<int> fixed(n_of_nodes, -1);
+        int n_fixed = reduce ? lp.fixByReducedCost(heuristic.size(), fixed) : 0;
+        cout << "heuristic " << heuristic.size() << "\tlower bound " << lower_bound;
+        cout << "\tfixed " << n_fixed << " of " << n_of_nodes << endl;
+
+        // the native backend is one thread; with more, the parallel exact
+        // search of exact_class.cpp solves the same model on the graph
+        bool parallelNative = solver->name() == "native" and n_threads > 1;
+
+        vector<int> var;
+        MIPModel model = buildModel(fixed, var);
+        if (symmetry and solver->name() == "native" and not parallelNative)
+            cout << "the native backend takes no symmetry rows" << endl;
+        else if (symmetry and not parallelNative) {
+            TwinClasses twins(graph);
+            vector< pair<int,int> > pairs = twins.orderPairs(fixed);
+            for (const auto& p : pairs) model.addRow({var[p.first], var[p.second]}, {1.0, -1.0}, 0.0);
+            cout << "twin classes " << twins.classes << "\ttwins " << twins.twins;
+            cout << "\tsymmetry rows " << pairs.size() << endl;
+        }
+        // the heuristic and the bound count against the time limit
+        double remaining = max(0.0, time_limit - timer.elapsed_time(clock));
+        MIPParams params;
+        params.threads = n_threads;
+        params.time_limit = remaining;
+        params.gap = gap;
+        int offset = 0;
+        for (int i = 0; i < n_of_nodes; ++i)
+            if (fixed[i] == 1) offset++;
+        params.lowerBound = lower_bound - offset;
+        params.start.assign(model.n_vars, 0.0);
+        for (int i : heuristic)
+            if (var[i] >= 0) params.start[var[i]] = 1.0;
+        // the reduced model only has to hold solutions smaller than the heuristic one
+        if (reduce) params.cutoff = int(heuristic.size()) - 1 - offset;
+        params.onIncumbent = [&](double value, double newGap) {
+            cout << "value " << value + offset << "\ttime " << timer.elapsed_time(clock) << "\tgap " << newGap << endl;
+        };
+
+        cout << "backend " << (parallelNative ? "native (parallel exact search)" : solver->name());
+        cout << "\tthreads " << n_threads;
+        cout << "\tvariables " << model.n_vars << "\trows " << model.n_rows() << endl;
+        MIPResult result;
+        if (parallelNative) {
+            ExactSolver exact(graph, n_threads, remaining);
+            // the fixings hold for every solution smaller than the heuristic one
+            if (reduce) exact.fixed = fixed;
+            exact.lowerBound = lower_bound;
+            if (symmetry) {
+                TwinClasses twins(graph);
+                cout << "twin classes " << twins.classes << "\ttwins " << twins.twins << endl;
+                exact.twinNext = twins.next;
+                exact.twinPrev = twins.prev;
+            }
+            exact.onImprove = [&](int size) {
+                cout << "value " << size << "\ttime " << timer.elapsed_time(clock);
+                cout << "\tgap " << 100.0*(size - lower_bound)/size << endl;
+            };
+            exact.solve(heuristic);
+            result.feasible = true;
+            result.optimal = exact.optimal;
+            result.nodes = exact.nodes;
+            result.value = exact.bestSolution.size();
+            result.gap = exact.optimal ? 0.0 : 100.0*(result.value - lower_bound)/result.value;
+            result.x.assign(model.n_vars, 0.0);
+            for (int i : exact.bestSolution)
+                if (var[i] >= 0) result.x[var[i]] = 1.0;
+        }
+        else if (not solver->solve(model, params, result)) {
+            cout << "Error: " << result.message << endl;
+            return 1;
+        }
+
+        vector<int> x(n_of_nodes, 0);
+        double value = 0.0;
+        if (result.feasible) {
+            for (int i = 0; i < n_of_nodes; ++i) {
+                // there is a reason for 'xval > 0.9' instead of 'xval == 1.0'
+                x[i] = fixed[i] == 1 or (var[i] >= 0 and result.x[var[i]] > 0.9);
+                value += x[i];
+            }
+        }
+        // if the reduced model has no solution, the heuristic one is optimal
+        if (reduce and (not result.feasible or value >= heuristic.size())) {
+            x.assign(n_of_nodes, 0);
+            for (int i : heuristic) x[i] = 1;
+            value = heuristic.size();
+            result.feasible = true;
+            result.gap = result.optimal ? 0.0 : 100.0*(value - lower_bound)/value;
+        }
+        if (not result.feasible) {
+            cout << "no solution found" << endl;
+            cout << "end application " << na + 1 << endl;
+            continue;
+        }
+
+        results[na] = value;
+        times[na] = timer.elapsed_time(clock);
+        cout << "value " << value;
+        cout << "\ttime " << times[na];
+        cout << "\tgap " << result.gap << endl;
+        if (result.optimal) cout << "optimality proven" << endl;
+        cout << "search nodes " << result.nodes << endl;
+
+        unordered_set<int> solution;
+        cout << "nodes/vertices in the solution: (";
+        bool first = true;
+        for (int i = 0; i < n_of_nodes; ++i) {
+            if (x[i]) {
+                solution.insert(i);
+                if (first) {
+                    cout << i;
+                    first = false;
+                }
+                else cout << "," << i;
+            }
+        }
+        cout << ")" << endl;
+
+        setNeighbor (neighbors);
+        if (not check_PIDS(solution)) cout << "Error: solution is not a PIDS" << endl;
+        cout << "end application " << na + 1 << endl;
+    }
+
+    // calculating the average of the results and computation times,
+    // and their standard deviations, and write them to the screen
+    double r_mean = 0.0;
+    int r_best = std::numeric_limits<int>::max();
+    double t_mean = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        r_mean = r_mean + results[i];
+        if (int(results[i]) < r_best) r_best = int(results[i]);
+        t_mean = t_mean + times[i];
+    }
+    r_mean = r_mean/double(results.size());
+    t_mean = t_mean/double(times.size());
+    double rsd = 0.0;
+    double tsd = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        rsd = rsd + pow(results[i]-r_mean,2.0);
+        tsd = tsd + pow(times[i]-t_mean,2.0);
+    }
+    rsd = rsd/double(results.size());
+    if (rsd > 0.0) {
+        rsd = sqrt(rsd);
+    }
+    tsd = tsd/double(results.size());
+    if (tsd > 0.0) {
+        tsd = sqrt(tsd);
+    }
+    // printing statistical information
+    cout << r_best << "\t" << r_mean << "\t" << rsd << "\t";
+    cout << t_mean << "\t" << tsd << endl;
+}
@@ -0,0 +1,464 @@
+/***************************************************************************
+    mpi_mpids.cpp
+    (C) 2021 by C. Blum & M. Blesa
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <mpi.h>
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <fstream>
+#include <cmath>
+#include <limits>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <climits>
+#include <algorithm>
+#include <iomanip>
+#include <sys/resource.h>
+
+using namespace std;
+
+// Distributed MPIDS: every rank owns a contiguous range of node ids with
+// their adjacency (1D vertex partition) and keeps a copy of the state of
+// the ghosts, the nodes of other ranks next to its own. All the work is
+// done in bulk-synchronous rounds: local computation, then one exchange
+// of the ghost values with MPI_Alltoallv.
+
+// string for keeping the name of the input file
+string inputFile;
+
+// a greedy round adds every non-member whose number of deficient
+// neighbors is at least <greedy_beta> times the largest one over all ranks
+double greedy_beta = 0.5;
+
+// 0 to skip the pruning of redundant members
+int prune_rounds = 1;
+
+// number of applications on the graph read once
+int n_apps = 1;
+
+int rank_id = 0;
+int n_ranks = 1;
+
+// bytes sent to other ranks and collective operations, for the report
+long long bytes_sent = 0;
+long long n_collectives = 0;
+
+
+void read_parameters(int argc, char **argv) {
+
+    int iarg = 1;
+    while (iarg < argc) {
+        if (strcmp(argv[iarg],"-i") == 0) inputFile = argv[++iarg];
+        else if (strcmp(argv[iarg],"-n_apps") == 0) n_apps = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-beta") == 0) greedy_beta = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-prune") == 0) prune_rounds = atoi(argv[++iarg]);
+        iarg++;
+    }
+}
+
+long long allreduce(long long value, MPI_Op op) {
+    long long result;
+    MPI_Allreduce(&value, &result, 1, MPI_LONG_LONG, op, MPI_COMM_WORLD);
+    n_collectives++;
+    return result;
+}
+
+
+//////////////////////////////////////////////////////////////
+//                 DISTRIBUTED GRAPH                        //
+//////////////////////////////////////////////////////////////
+
+// The nodes lo..hi-1 of this rank in CSR form, with the global ids of
+// their neighbors. Neighbors of other ranks are ghosts: adj holds local
+// indices, 0..n_local-1 for own nodes and n_local + g for ghost g.
+struct DistGraph {
+    int n = 0;       // nodes in the whole graph
+    int lo = 0;
+    int hi = 0;
+    int n_local = 0;
+    vector<long> start;
+    vector<int> adj;
+    vector<int> need;
+    vector<int> ghostId; // global id of every ghost, sorted
+
+    // ghost exchange: the own nodes whose values go to every rank, and
+    // where the values from every rank go among the ghosts
+    vector<int> sendCounts, sendDispls, sendIndex;
+    vector<int> recvCounts, recvDispls;
+
+    int ownerOf(int v) const {
+        // the first rank whose range ends after v
+        int r = int(long(v)*n_ranks/n);
+        while (r > 0 and v < first(r)) r--;
+        while (r < n_ranks - 1 and v >= first(r + 1)) r++;
+        return r;
+    }
+    int first(int r) const { return int(long(r)*n/n_ranks); }
+    int degree(int a) const { return int(start[a + 1] - start[a]); }
+
+    // Every rank reads the file twice and keeps the edges of its nodes:
+    // once to count, once to fill the CSR
+    bool read(const string& file) {
+        for (int pass = 0; pass < 2; pass++) {
+            ifstream indata(file.c_str());
+            if (not indata) return false;
+            long m;
+            indata >> n >> m;
+            if (pass == 0) {
+                lo = first(rank_id);
+                hi = first(rank_id + 1);
+                n_local = hi - lo;
+                start.assign(n_local + 1, 0);
+            }
+            vector<long> fill(start.begin(), start.end() - 1);
+            int u, v;
+            while (indata >> u >> v) {
+                u--;
+                v--;
+                if (u == v) continue;
+                for (int e = 0; e < 2; e++) {
+                    if (u >= lo and u < hi) {
+                        if (pass == 0) start[u - lo + 1]++;
+                        else adj[fill[u - lo]++] = v;
+                    }
+                    swap(u, v);
+                }
+            }
+            if (pass == 0) {
+                for (int a = 0; a < n_local; a++) start[a + 1] += start[a];
+                adj.resize(start[n_local]);
+            }
+        }
+
+        // duplicates out, then global ids to local indices
+        long k = 0;
+        for (int a = 0; a < n_local; a++) {
+            long b = start[a];
+            sort(adj.begin() + b, adj.begin() + start[a + 1]);
+            long e = unique(adj.begin() + b, adj.begin() + start[a + 1]) - adj.begin();
+            start[a] = k;
+            for (long i = b; i < e; i++) adj[k++] = adj[i];
+        }
+        start[n_local] = k;
+        adj.resize(k);
+        adj.shrink_to_fit();
+        for (int w : adj)
+            if (w < lo or w >= hi) ghostId.push_back(w);
+        sort(ghostId.begin(), ghostId.end());
+        ghostId.erase(unique(ghostId.begin(), ghostId.end()), ghostId.end());
+        for (int& w : adj) {
+            if (w >= lo and w < hi) w -= lo;
+            else w = n_local + int(lower_bound(ghostId.begin(), ghostId.end(), w) - ghostId.begin());
+        }
+        need.resize(n_local);
+        for (int a = 0; a < n_local; a++) need[a] = (degree(a) + 1)/2;
+        setupExchange();
+        return true;
+    }
+
+    // Every ghost tells its owner that this rank wants its values; the
+    // owner answers in the same order ever after. Ghosts are sorted by id,
+    // hence by owner, so the values of every rank land in one piece
+    void setupExchange() {
+        recvCounts.assign(n_ranks, 0);
+        for (int w : ghostId) recvCounts[ownerOf(w)]++;
+        recvDispls.assign(n_ranks + 1, 0);
+        for (int r = 0; r < n_ranks; r++) recvDispls[r + 1] = recvDispls[r] + recvCounts[r];
+        sendCounts.assign(n_ranks, 0);
+        MPI_Alltoall(recvCounts.data(), 1, MPI_INT, sendCounts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+        n_collectives++;
+        sendDispls.assign(n_ranks + 1, 0);
+        for (int r = 0; r < n_ranks; r++) sendDispls[r + 1] = sendDispls[r] + sendCounts[r];
+        sendIndex.resize(sendDispls[n_ranks]);
+        MPI_Alltoallv(ghostId.data(), recvCounts.data(), recvDispls.data(), MPI_INT,
+                      sendIndex.data(), sendCounts.data(), sendDispls.data(), MPI_INT, MPI_COMM_WORLD);
+        n_collectives++;
+        for (int r = 0; r < n_ranks; r++)
+            if (r != rank_id) bytes_sent += long(recvCounts[r])*sizeof(int);
+        for (int& v : sendIndex) v -= lo;
+    }
+
+    // values[0..n_local-1] hold the own values; their copies on the
+    // other ranks are refreshed into values[n_local..]
+    template <class T>
+    void exchange(vector<T>& values) {
+        vector<T> out(sendIndex.size());
+        for (size_t i = 0; i < sendIndex.size(); i++) out[i] = values[sendIndex[i]];
+        vector<int> sc(n_ranks), sd(n_ranks), rc(n_ranks), rd(n_ranks);
+        for (int r = 0; r < n_ranks; r++) {
+            sc[r] = sendCounts[r]*sizeof(T);
+            sd[r] = sendDispls[r]*sizeof(T);
+            rc[r] = recvCounts[r]*sizeof(T);
+            rd[r] = recvDispls[r]*sizeof(T);
+            if (r != rank_id) bytes_sent += sc[r];
+        }
+        MPI_Alltoallv(out.data(), sc.data(), sd.data(), MPI_BYTE,
+                      values.data() + n_local, rc.data(), rd.data(), MPI_BYTE, MPI_COMM_WORLD);
+        n_collectives++;
+    }
+
+    long long memory() const {
+        return sizeof(long)*start.capacity() + sizeof(int)*(adj.capacity() + need.capacity() +
+               ghostId.capacity() + sendIndex.capacity());
+    }
+};
+
+
+//////////////////////////////////////////////////////////////
+//                 DISTRIBUTED SOLUTION                     //
+//////////////////////////////////////////////////////////////
+
+struct DistSolution {
+    DistGraph& g;
+    vector<int> in;        // own nodes and ghosts
+    vector<int> popularity; // member neighbors of the own nodes
+    int greedyRounds = 0;
+    int pruneRounds = 0;
+
+    DistSolution(DistGraph& graph)
+        : g(graph), in(graph.n_local + graph.ghostId.size(), 0), popularity(graph.n_local, 0) {}
+
+    // popularity from the members, ghosts refreshed first
+    void count() {
+        g.exchange(in);
+        for (int a = 0; a < g.n_local; a++) {
+            int p = 0;
+            for (long e = g.start[a]; e < g.start[a + 1]; e++) p += in[g.adj[e]];
+            popularity[a] = p;
+        }
+    }
+
+    long long size() {
+        long long s = 0;
+        for (int a = 0; a < g.n_local; a++) s += in[a];
+        return allreduce(s, MPI_SUM);
+    }
+
+    // Rounds of threshold greedy: the non-members with the most deficient
+    // neighbors, up to a factor greedy_beta, join together
+    void greedy() {
+        vector<int> deficit(in.size(), 0);
+        count();
+        while (true) {
+            long long total = 0;
+            for (int a = 0; a < g.n_local; a++) {
+                deficit[a] = max(0, g.need[a] - popularity[a]);
+                total += deficit[a];
+            }
+            if (allreduce(total, MPI_SUM) == 0) break;
+            greedyRounds++;
+            g.exchange(deficit);
+            vector<int> score(g.n_local, 0);
+            long long best = 0;
+            for (int a = 0; a < g.n_local; a++) {
+                if (in[a]) continue;
+                for (long e = g.start[a]; e < g.start[a + 1]; e++) score[a] += deficit[g.adj[e]] > 0;
+                best = max(best, (long long)score[a]);
+            }
+            best = allreduce(best, MPI_MAX);
+            int threshold = max(1, int(ceil(greedy_beta*best)));
+            for (int a = 0; a < g.n_local; a++)
+                if (not in[a] and score[a] >= threshold) in[a] = 1;
+            count();
+        }
+    }
+
+    // Rounds of redundancy pruning. A member whose neighbors all have
+    // slack proposes to leave; every node grants it to the first of its
+    // proposing neighbors, in the order (degree, id), up to its slack,
+    // and a member leaves when all its neighbors grant it. The first
+    // proposer of all is granted everywhere, so every round removes one
+    // at least, and no threshold is broken
+    void prune() {
+        const long long INF = LLONG_MAX;
+        int total = in.size();
+        vector<long long> key(total);
+        vector<int> degree(total, 0);
+        for (int a = 0; a < g.n_local; a++) degree[a] = g.degree(a);
+        g.exchange(degree);
+        for (int a = 0; a < total; a++) {
+            int id = a < g.n_local ? g.lo + a : g.ghostId[a - g.n_local];
+            key[a] = (long long)degree[a]*g.n + id;
+        }
+        vector<int> slack(total, 0);
+        vector<int> proposed(total, 0);
+        vector<long long> grant(total, INF);
+        vector<long long> keys;
+        while (true) {
+            for (int a = 0; a < g.n_local; a++) slack[a] = popularity[a] - g.need[a];
+            g.exchange(slack);
+            long long proposals = 0;
+            for (int a = 0; a < g.n_local; a++) {
+                proposed[a] = in[a];
+                for (long e = g.start[a]; e < g.start[a + 1] and proposed[a]; e++)
+                    if (slack[g.adj[e]] <= 0) proposed[a] = 0;
+                proposals += proposed[a];
+            }
+            if (allreduce(proposals, MPI_SUM) == 0) break;
+            pruneRounds++;
+            g.exchange(proposed);
+            for (int a = 0; a < g.n_local; a++) {
+                keys.clear();
+                for (long e = g.start[a]; e < g.start[a + 1]; e++)
+                    if (proposed[g.adj[e]]) keys.push_back(key[g.adj[e]]);
+                grant[a] = INF;
+                if (int(keys.size()) > slack[a] and slack[a] > 0) {
+                    nth_element(keys.begin(), keys.begin() + slack[a] - 1, keys.end());
+                    grant[a] = keys[slack[a] - 1];
+                }
+            }
+            g.exchange(grant);
+            for (int a = 0; a < g.n_local; a++) {
+                if (not proposed[a]) continue;
+                bool granted = true;
+                for (long e = g.start[a]; e < g.start[a + 1] and granted; e++) granted = key[a] <= grant[g.adj[e]];
+                if (granted) in[a] = 0;
+            }
+            count();
+        }
+    }
+
+    // every own node meets its threshold
+    bool feasible() {
+        long long bad = 0;
+        for (int a = 0; a < g.n_local; a++) bad += popularity[a] < g.need[a];
+        return allreduce(bad, MPI_SUM) == 0;
+    }
+};
+
+
+// Main function
+
+int main( int argc, char **argv ) {
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank_id);
+    MPI_Comm_size(MPI_COMM_WORLD, &n_ranks);
+
+    read_parameters(argc,argv);
+
+    // setting the output format for doubles to 2 decimals after the comma
+    std::cout << std::setprecision(2) << std::fixed;
+
+    // the computation time starts now, reading included
+    double t0 = MPI_Wtime();
+
+    DistGraph graph;
+    int ok = graph.read(inputFile);
+    int all_ok;
+    MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    if (not all_ok) {
+        if (rank_id == 0) cout << "Error: file could not be opened" << endl;
+        MPI_Finalize();
+        return 1;
+    }
+    double t_read = MPI_Wtime() - t0;
+
+    if (rank_id == 0) cout << "ranks " << n_ranks << "\tread time " << t_read << endl;
+
+    // vectors for storing the result and the computation time
+    // obtained by the <n_apps> applications
+    vector<double> results(n_apps, std::numeric_limits<int>::max());
+    vector<double> times(n_apps, 0.0);
+
+    // main loop over all applications; the reading time is not repeated
+    for (int na = 0; na < n_apps; ++na) {
+
+        double start = MPI_Wtime();
+        if (rank_id == 0) cout << "start application " << na + 1 << endl;
+
+        DistSolution solution(graph);
+        solution.greedy();
+        long long value = solution.size();
+        times[na] = t_read + MPI_Wtime() - start;
+        if (rank_id == 0) {
+            cout << "greedy rounds " << solution.greedyRounds << endl;
+            cout << "value " << value << "\ttime " << times[na] << endl;
+        }
+        if (prune_rounds) {
+            solution.prune();
+            value = solution.size();
+            times[na] = t_read + MPI_Wtime() - start;
+            if (rank_id == 0) {
+                cout << "prune rounds " << solution.pruneRounds << endl;
+                cout << "value " << value << "\ttime " << times[na] << endl;
+            }
+        }
+        results[na] = value;
+        if (not solution.feasible() and rank_id == 0) cout << "Error: solution is not a PIDS" << endl;
+        if (rank_id == 0) cout << "end application " << na + 1 << endl;
+    }
+
+    // per rank report, gathered on rank 0
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    long long local[6] = { graph.n_local, (long long) graph.adj.size(), (long long) graph.ghostId.size(),
+                           graph.memory() + (long long)(sizeof(int)*(2*graph.n_local + graph.ghostId.size())),
+                           usage.ru_maxrss, bytes_sent };
+    vector<long long> all(6*n_ranks);
+    MPI_Gather(local, 6, MPI_LONG_LONG, all.data(), 6, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+    if (rank_id == 0) {
+        long long volume = 0;
+        for (int r = 0; r < n_ranks; r++) {
+            long long* x = all.data() + 6*r;
+            cout << "rank " << r << "\tnodes " << x[0] << "\tarcs " << x[1] << "\tghosts " << x[2];
+            cout << "\tgraph memory " << x[3]/1048576.0 << " MB\tpeak memory " << x[4]/1024.0 << " MB";
+            cout << "\tsent " << x[5]/1048576.0 << " MB" << endl;
+            volume += x[5];
+        }
+        cout << "communication " << volume/1048576.0 << " MB\tcollectives " << n_collectives;
+        cout << "\ttime " << MPI_Wtime() - t0 << endl;
+
+        // calculating the average of the results and computation times,
+        // and their standard deviations, and write them to the screen
+        double r_mean = 0.0;
+        int r_best = std::numeric_limits<int>::max();
+        double t_mean = 0.0;
+        for (int i = 0; i < int(results.size()); i++) {
+            r_mean = r_mean + results[i];
+            if (int(results[i]) < r_best) r_best = int(results[i]);
+            t_mean = t_mean + times[i];
+        }
+        r_mean = r_mean/double(results.size());
+        t_mean = t_mean/double(times.size());
+        double rsd = 0.0;
+        double tsd = 0.0;
+        for (int i = 0; i < int(results.size()); i++) {
+            rsd = rsd + pow(results[i]-r_mean,2.0);
+            tsd = tsd + pow(times[i]-t_mean,2.0);
+        }
+        rsd = rsd/double(results.size());
+        if (rsd > 0.0) {
+            rsd = sqrt(rsd);
+        }
+        tsd = tsd/double(results.size());
+        if (tsd > 0.0) {
+            tsd = sqrt(tsd);
+        }
+        // printing statistical information
+        cout << r_best << "\t" << r_mean << "\t" << rsd << "\t";
+        cout << t_mean << "\t" << tsd << endl;
+    }
+
+    MPI_Finalize();
+}
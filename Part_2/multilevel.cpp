@@ -0,0 +1,274 @@
+/***************************************************************************
+    multilevel.cpp
+    (C) 2021 by C. Blum & M. Blesa
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Timer.h"
+#include "Random.h"
+#include "../Part_1/greedy_class.cpp"
+#include "pids_class.cpp"
+#include "tabu_class.cpp"
+#include "exact_class.cpp"
+#include "ccls_class.cpp"
+#include "multilevel_class.cpp"
+#include "bound_class.cpp"
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <fstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include <limits>
+#include <iomanip>
+
+// global variables concerning the random number generator (in case needed)
+time_t t;
+Random* rnd;
+
+// Data structures for the problem data
+int n_of_nodes;
+int n_of_arcs;
+vector< unordered_set<int> > neighbors;
+Graph graph;
+
+// string for keeping the name of the input file
+string inputFile;
+
+// computing time limit for each application of the metaheuristic
+double time_limit = 600.0;
+
+// number of applications of the metaheuristic
+int n_apps = 1;
+
+// coarsening stops at <coarsest> nodes, after <max_levels> levels or
+// when a level shrinks by less than 5%. Neighbors of degree above
+// <scan_limit> are not scanned for common neighbors and nodes standing
+// for <max_weight> input nodes are not matched any more
+int coarsest = 500;
+int max_levels = 30;
+int scan_limit = 256;
+int max_weight = 64;
+
+// the coarsest level is solved by "tabu" (<tabu_iterations> iterations
+// from a greedy solution) or by "exact" (the branch and bound started
+// from the tabu solution, for at most <exact_time> seconds)
+string coarse_solver = "tabu";
+int64_t tabu_iterations = 2000;
+double exact_time = 10.0;
+
+// configuration checking steps per node to refine every level on the way
+// back; the input graph gets the rest of the time
+int refine_steps = 10;
+
+// passes of the LP lower bound printed next to every result, 0 to skip it
+int lb_iterations = 500;
+
+
+void read_parameters(int argc, char **argv) {
+
+    int iarg = 1;
+    while (iarg < argc) {
+        if (strcmp(argv[iarg],"-i") == 0) inputFile = argv[++iarg];
+        // reading the computation time limit
+        // from the command line (if provided)
+        else if (strcmp(argv[iarg],"-t") == 0) time_limit = atoi(argv[++iarg]);
+        // reading the number of applications of the metaheuristic
+        // from the command line (if provided)
+        else if (strcmp(argv[iarg],"-n_apps") == 0) n_apps = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-coarsest") == 0) coarsest = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-levels") == 0) max_levels = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-scan") == 0) scan_limit = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-max_weight") == 0) max_weight = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-coarse") == 0) coarse_solver = argv[++iarg];
+        else if (strcmp(argv[iarg],"-tabu") == 0) tabu_iterations = atoll(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-exact_t") == 0) exact_time = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-refine") == 0) refine_steps = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-lb") == 0) lb_iterations = atoi(argv[++iarg]);
+        iarg++;
+    }
+}
+
+/**********
+Main function
+**********/
+
+int main( int argc, char **argv ) {
+
+    read_parameters(argc,argv);
+
+    // setting the output format for doubles to 2 decimals after the comma
+    std::cout << std::setprecision(2) << std::fixed;
+
+    // initializing the random number generator. A random number
+    // between 0 and 1 is obtained with: double rnum = rnd->next();
+    rnd = new Random((unsigned) time(&t));
+    rnd->next();
+
+    // vectors for storing the result and the computation time
+    // obtained by the <n_apps> applications of the metaheuristic
+    vector<double> results(n_apps, std::numeric_limits<int>::max());
+    vector<double> times(n_apps, 0.0);
+
+    // opening the corresponding input file and reading the problem data
+    ifstream indata;
+    indata.open(inputFile.c_str());
+    if (not indata) { // file couldn't be opened
+        cout << "Error: file could not be opened" << endl;
+    }
+
+    indata >> n_of_nodes;
+    indata >> n_of_arcs;
+    neighbors = vector< unordered_set<int> >(n_of_nodes);
+    int u, v;
+    while (indata >> u >> v) {
+        neighbors[u - 1].insert(v - 1);
+        neighbors[v - 1].insert(u - 1);
+    }
+    indata.close();
+    graph = buildGraph(neighbors);
+
+    // certified lower bound from the LP relaxation
+    int lower_bound = lpLowerBound(graph, lb_iterations);
+
+    setNeighbor (neighbors);
+
+    // main loop over all applications of the metaheuristic
+    for (int na = 0; na < n_apps; ++na) {
+
+        // the computation time starts now
+        Timer timer;
+
+        cout << "start application " << na + 1 << endl;
+
+        // levels[0] is the input; parents[l] maps the nodes of level l to level l + 1
+        vector<Graph> levels(1, graph);
+        vector< vector<int> > parents;
+        vector<int> weight(graph.n, 1);
+        while (levels.back().n > coarsest and int(levels.size()) <= max_levels) {
+            vector<int> parent;
+            vector<int> w = weight;
+            Graph next = coarsen(levels.back(), parent, w, rnd, scan_limit, max_weight);
+            if (next.n > 0.95*levels.back().n) break;
+            levels.push_back(next);
+            parents.push_back(parent);
+            weight.swap(w);
+        }
+        for (int l = 0; l < int(levels.size()); l++)
+            cout << "level " << l << "\tnodes " << levels[l].n << "\tedges " << levels[l].m << endl;
+        cout << "coarsening time " << timer.elapsed_time(Timer::VIRTUAL) << endl;
+
+        // the coarsest level: greedy and tabu, then the exact search if asked
+        int top = levels.size() - 1;
+        PIDSState state;
+        state.init(levels[top]);
+        state.repair();
+        state.pruneAll();
+        cout << "level " << top << "\tgreedy " << state.size();
+        // the engine hooks into the state until it is destroyed, so it
+        // lives in its own block, apart from the finer levels
+        {
+            int64_t tenure = 10 + levels[top].n/100;
+            TabuEngine tabu(state, rnd, tenure, tenure);
+            tabu.run(timer, time_limit, tabu_iterations);
+        }
+        vector<int> members = state.members;
+        cout << "\ttabu " << members.size();
+        if (coarse_solver == "exact" and timer.elapsed_time(Timer::VIRTUAL) < time_limit) {
+            ExactSolver exact(levels[top], 1, min(exact_time, time_limit - timer.elapsed_time(Timer::VIRTUAL)));
+            if (exact.solve(members)) members = exact.bestSolution;
+            cout << "\texact " << members.size();
+            if (exact.optimal) cout << " (optimal)";
+        }
+        cout << "\ttime " << timer.elapsed_time(Timer::VIRTUAL) << endl;
+
+        // project back: repair, prune and refine every level
+        for (int l = top - 1; l >= 0; l--) {
+            const Graph& g = levels[l];
+            vector<int> fine = project(g, parents[l], levels[l + 1].n, members);
+            state.init(g);
+            state.load(fine);
+            cout << "level " << l << "\tprojected " << state.size();
+            state.repair();
+            cout << "\trepaired " << state.size();
+            state.pruneAll();
+            cout << "\tpruned " << state.size();
+            members = state.members;
+            if (l > 0) {
+                CCLocalSearch refine(g, rnd);
+                refine.load(members);
+                refine.run(timer, Timer::VIRTUAL, time_limit, int64_t(refine_steps)*g.n);
+                members = refine.best;
+            }
+            cout << "\tvalue " << members.size() << "\ttime " << timer.elapsed_time(Timer::VIRTUAL) << endl;
+        }
+
+        results[na] = members.size();
+        times[na] = timer.elapsed_time(Timer::VIRTUAL);
+        cout << "value " << members.size() << "\ttime " << times[na] << endl;
+
+        // the rest of the time on the input graph
+        CCLocalSearch search(graph, rnd);
+        search.load(members);
+        search.onImprove = [&](int k) {
+            results[na] = k;
+            times[na] = timer.elapsed_time(Timer::VIRTUAL);
+            cout << "value " << k << "\ttime " << times[na] << endl;
+        };
+        search.run(timer, Timer::VIRTUAL, time_limit);
+
+        unordered_set<int> solution(search.best.begin(), search.best.end());
+        if (not check_PIDS(solution)) cout << "Error: solution is not a PIDS" << endl;
+
+        printGap(lower_bound, results[na]);
+        cout << "end application " << na + 1 << endl;
+    }
+
+    // calculating the average of the results and computation times,
+    // and their standard deviations, and write them to the screen
+    double r_mean = 0.0;
+    int r_best = std::numeric_limits<int>::max();
+    double t_mean = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        r_mean = r_mean + results[i];
+        if (int(results[i]) < r_best) r_best = int(results[i]);
+        t_mean = t_mean + times[i];
+    }
+    r_mean = r_mean/double(results.size());
+    t_mean = t_mean/double(times.size());
+    double rsd = 0.0;
+    double tsd = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        rsd = rsd + pow(results[i]-r_mean,2.0);
+        tsd = tsd + pow(times[i]-t_mean,2.0);
+    }
+    rsd = rsd/double(results.size());
+    if (rsd > 0.0) {
+        rsd = sqrt(rsd);
+    }
+    tsd = tsd/double(results.size());
+    if (tsd > 0.0) {
+        tsd = sqrt(tsd);
+    }
+    // printing statistical information
+    cout << r_best << "\t" << r_mean << "\t" << rsd << "\t";
+    cout << t_mean << "\t" << tsd << endl;
+}
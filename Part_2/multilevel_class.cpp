@@ -0,0 +1,117 @@
+#ifndef MULTILEVEL_CLASS_CPP
+#define MULTILEVEL_CLASS_CPP
+
+#include "pids_class.cpp"
+#include "Random.h"
+#include <vector>
+#include <unordered_set>
+#include <algorithm>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////
+//                      COARSENING                          //
+//////////////////////////////////////////////////////////////
+
+// One coarsening step: a matching of the graph is contracted. Nodes are
+// visited in random order and each unmatched one is matched with the
+// unmatched neighbor it shares most neighbors with (heavy-edge matching,
+// the weight of an edge being one plus its common neighbors), the least
+// heavy one on ties. A matched pair becomes a single node adjacent to the
+// neighbors of both, and its threshold is again half its degree, so every
+// level is an MPIDS instance of its own; a member of a coarse solution
+// stands for both nodes of its pair.
+//   parent[v]: coarse node of the fine node v
+//   weight[v]: input nodes contracted into v, on input and on output
+// Neighbors of degree above scanLimit are not scanned for common
+// neighbors, to keep the step linear on graphs with hubs, and nodes of
+// weight maxWeight are not matched any more.
+Graph coarsen(const Graph& fine, vector<int>& parent, vector<int>& weight, Random* rnd,
+              int scanLimit = 256, int maxWeight = 64) {
+    int n = fine.n;
+    vector<int> order(n);
+    for (int v = 0; v < n; v++) order[v] = v;
+    for (int v = n - 1; v > 0; v--) swap(order[v], order[int(rnd->next()*(v + 1)) % (v + 1)]);
+
+    vector<int> mate(n, -1);
+    vector<int> mark(n, -1);
+    int n_coarse = 0;
+    for (int u : order) {
+        if (mate[u] >= 0) continue;
+        n_coarse++;
+        if (weight[u] >= maxWeight) continue;
+        int best = -1;
+        int bestScore = -1;
+        for (const int* w = fine.begin(u); w != fine.end(u); ++w) mark[*w] = u;
+        for (const int* w = fine.begin(u); w != fine.end(u); ++w) {
+            int v = *w;
+            if (mate[v] >= 0 or weight[v] >= maxWeight) continue;
+            int score = 0;
+            if (fine.degree(v) <= scanLimit)
+                for (const int* y = fine.begin(v); y != fine.end(v); ++y) score += mark[*y] == u;
+            if (score > bestScore or (score == bestScore and weight[v] < weight[best])) {
+                best = v;
+                bestScore = score;
+            }
+        }
+        if (best >= 0) {
+            mate[u] = best;
+            mate[best] = u;
+        }
+        else mate[u] = u;
+    }
+    // Two-hop matching, as in METIS, when the graph hardly shrinks (stars
+    // whose leaves can only go with the center): unmatched nodes next to
+    // the same node are paired although they are not adjacent
+    if (n_coarse > 0.75*n) {
+        for (int x : order) {
+            int open = -1;
+            for (const int* w = fine.begin(x); w != fine.end(x); ++w) {
+                int v = *w;
+                if (mate[v] != v or weight[v] >= maxWeight) continue;
+                if (open < 0) open = v;
+                else {
+                    mate[open] = v;
+                    mate[v] = open;
+                    open = -1;
+                    n_coarse--;
+                }
+            }
+        }
+    }
+    parent.assign(n, -1);
+    int next = 0;
+    for (int u : order) {
+        if (parent[u] >= 0) continue;
+        parent[u] = next;
+        if (mate[u] >= 0) parent[mate[u]] = next;
+        next++;
+    }
+
+    vector< unordered_set<int> > nb(n_coarse);
+    vector<int> coarseWeight(n_coarse, 0);
+    for (int v = 0; v < n; v++) {
+        coarseWeight[parent[v]] += weight[v];
+        for (const int* w = fine.begin(v); w != fine.end(v); ++w)
+            if (parent[*w] != parent[v]) nb[parent[v]].insert(parent[*w]);
+    }
+    weight.swap(coarseWeight);
+    return buildGraph(nb);
+}
+
+// Fine nodes standing for the coarse solution members: the end of every
+// pair with the larger degree, the repair adds the other one if needed
+vector<int> project(const Graph& fine, const vector<int>& parent, int n_coarse, const vector<int>& members) {
+    vector<int> pick(n_coarse, -1);
+    for (int c : members) pick[c] = -2;
+    for (int v = 0; v < fine.n; v++) {
+        int& p = pick[parent[v]];
+        if (p == -1) continue;
+        if (p == -2 or fine.degree(v) > fine.degree(p)) p = v;
+    }
+    vector<int> chosen;
+    for (int c : members) chosen.push_back(pick[c]);
+    return chosen;
+}
+
+#endif
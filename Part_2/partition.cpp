@@ -0,0 +1,326 @@
+/***************************************************************************
+    partition.cpp
+    (C) 2021 by C. Blum & M. Blesa
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Timer.h"
+#include "../Part_1/greedy_class.cpp"
+#include "Random.h"
+#include "pids_class.cpp"
+#include "ccls_class.cpp"
+#include "partition_class.cpp"
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <fstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include <limits>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <time.h>
+#include <cfloat>
+
+// global variables concerning the random number generator (in case needed)
+time_t t;
+Random* rnd;
+
+// Data structures for the problem data
+int n_of_nodes;
+int n_of_arcs;
+vector< unordered_set<int> > neighbors;
+Graph graph;
+
+// string for keeping the name of the input file
+string inputFile;
+
+// the graph is split into <n_blocks> blocks of at most <imbalance> times
+// the average size by at most <rounds> rounds of label propagation
+int n_blocks = 8;
+double imbalance = 1.05;
+int rounds = 20;
+
+// blocks are solved by <n_threads> threads, each one by greedy and the
+// configuration-checking search; the blocks take the first 1 - <polish>
+// of <time_limit> seconds, the search on the whole graph after stitching
+// the rest
+int n_threads = 1;
+double time_limit = 60.0;
+double polish = 0.1;
+
+// number of applications
+int n_apps = 1;
+
+// 1 to compare with the configuration-checking search on the whole graph
+// given the same time
+int sequential = 0;
+
+// speedup of the block phase: the blocks are solved again for <speedup>
+// steps each on 1, 2, 4, ... up to <n_threads> threads, 0 to skip it
+int64_t speedup_steps = 10000;
+
+
+void read_parameters(int argc, char **argv) {
+
+    int iarg = 1;
+    while (iarg < argc) {
+        if (strcmp(argv[iarg],"-i") == 0) inputFile = argv[++iarg];
+        else if (strcmp(argv[iarg],"-t") == 0) time_limit = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-n_apps") == 0) n_apps = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-k") == 0) n_blocks = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-imbalance") == 0) imbalance = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-rounds") == 0) rounds = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-threads") == 0) n_threads = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-polish") == 0) polish = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-seq") == 0) sequential = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-speedup") == 0) speedup_steps = atoll(argv[++iarg]);
+        iarg++;
+    }
+}
+
+// CPU time of the calling thread, to tell the work done in the blocks
+// from the wall-clock time it took
+double threadTime() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+// Solve every block by greedy and the configuration-checking search on
+// n_workers threads, each one taking the next block until none is left.
+// A block runs for at most blockTime seconds and max_steps steps (-1 for
+// no limit), and no block runs past phaseTime seconds from the call.
+// Block b draws from a generator seeded with seeds[b], so with a step
+// budget the work does not depend on n_workers. Returns the wall-clock
+// time of the phase
+double solveBlocks(const Partition& partition, const vector<int>& seeds, int n_workers,
+                   double blockTime, double phaseTime, int64_t max_steps,
+                   vector< vector<int> >& blockSolution, vector<double>& blockTimes, vector<int>& blockSizes) {
+    int k = partition.k;
+    blockSolution.assign(k, vector<int>());
+    blockTimes.assign(k, 0.0);
+    blockSizes.assign(k, 0);
+    atomic<int> nextBlock(0);
+    // one clock per thread, started here: Timer is not safe to share
+    vector<Timer> clocks(n_workers);
+    auto work = [&](int i) {
+        vector<int> local(graph.n, -1);
+        for (int b = nextBlock++; b < k; b = nextBlock++) {
+            Timer blockTimer;
+            double cpu = threadTime();
+            const vector<int>& nodes = partition.nodes[b];
+            if (nodes.empty()) continue;
+            double limit = min(blockTime, phaseTime - clocks[i].elapsed_time(Timer::REAL));
+            Graph sub = blockGraph(graph, nodes, local);
+            Random r(seeds[b]);
+            PIDSState state;
+            state.init(sub);
+            state.repair();
+            state.pruneAll();
+            CCLocalSearch search(sub, &r);
+            search.load(state.members);
+            search.run(blockTimer, Timer::REAL, limit, max_steps);
+            for (int a : search.best) blockSolution[b].push_back(nodes[a]);
+            blockTimes[b] = threadTime() - cpu;
+            blockSizes[b] = search.best.size();
+        }
+    };
+    vector<thread> pool;
+    for (int i = 1; i < n_workers; i++) pool.push_back(thread(work, i));
+    work(0);
+    for (thread& th : pool) th.join();
+    return clocks[0].elapsed_time(Timer::REAL);
+}
+
+
+// Main function
+
+int main( int argc, char **argv ) {
+
+    read_parameters(argc,argv);
+
+    // setting the output format for doubles to 2 decimals after the comma
+    std::cout << std::setprecision(2) << std::fixed;
+
+    rnd = new Random((unsigned) time(&t));
+    rnd->next();
+
+    // opening the corresponding input file and reading the problem data
+    ifstream indata;
+    indata.open(inputFile.c_str());
+    if (not indata) { // file couldn't be opened
+        cout << "Error: file could not be opened" << endl;
+    }
+
+    indata >> n_of_nodes;
+    indata >> n_of_arcs;
+    neighbors = vector< unordered_set<int> >(n_of_nodes);
+    int u, v;
+    while (indata >> u >> v) {
+        neighbors[u - 1].insert(v - 1);
+        neighbors[v - 1].insert(u - 1);
+    }
+    indata.close();
+    graph = buildGraph(neighbors);
+
+    // vectors for storing the result and the computation time
+    // obtained by the <n_apps> applications
+    vector<double> results(n_apps, std::numeric_limits<int>::max());
+    vector<double> times(n_apps, 0.0);
+
+    // main loop over all applications
+    for (int na = 0; na < n_apps; ++na) {
+
+        // the computation time starts now; the blocks are solved in parallel,
+        // so all times are wall-clock times
+        Timer timer;
+
+        cout << "start application " << na + 1 << endl;
+
+        Partition partition(graph, n_blocks, rnd, imbalance, rounds);
+        int k = partition.k;
+        size_t largest = 0;
+        size_t smallest = graph.n;
+        for (const vector<int>& nodes : partition.nodes) {
+            largest = max(largest, nodes.size());
+            smallest = min(smallest, nodes.size());
+        }
+        cout << "blocks " << k << "\tcut " << partition.cut << " (" << 100.0*partition.cut/max(graph.m, 1L) << "%)";
+        cout << "\tlargest " << largest << "\tsmallest " << smallest << "\trounds " << partition.rounds;
+        cout << "\ttime " << timer.elapsed_time(Timer::REAL) << endl;
+
+        // the block phase takes the first 1 - <polish> of the time limit.
+        // At most k threads have a block, and they need ceil(k/threads)
+        // rounds, so every block gets the rest of the phase over the rounds
+        int workers = max(1, min(n_threads, k));
+        int waves = (k + workers - 1)/workers;
+        double phaseTime = max(0.0, (1.0 - polish)*time_limit - timer.elapsed_time(Timer::REAL));
+        double blockTime = phaseTime/waves;
+        vector<int> seeds;
+        for (int b = 0; b < k; b++) seeds.push_back(int(rnd->next()*2147483646) + 1);
+        vector< vector<int> > blockSolution;
+        vector<double> blockTimes;
+        vector<int> blockSizes;
+        double wall = solveBlocks(partition, seeds, workers, blockTime, phaseTime, -1,
+                                  blockSolution, blockTimes, blockSizes);
+        double busy = 0.0;
+        for (int b = 0; b < k; b++) {
+            cout << "block " << b << "\tnodes " << partition.nodes[b].size() << "\tvalue " << blockSizes[b];
+            cout << "\ttime " << blockTimes[b] << endl;
+            busy += blockTimes[b];
+        }
+        cout << "threads " << workers << "\tblock CPU time " << busy << "\twall time " << wall << endl;
+
+        // stitching: the union, with the thresholds the blocks only guessed
+        // repaired, and then pruned
+        PIDSState state;
+        state.init(graph);
+        for (const vector<int>& part : blockSolution)
+            for (int w : part) state.add(w);
+        cout << "stitched " << state.size();
+        state.repair();
+        cout << "\trepaired " << state.size();
+        state.pruneAll();
+        cout << "\tpruned " << state.size() << endl;
+        vector<int> solution = state.members;
+        results[na] = solution.size();
+        times[na] = timer.elapsed_time(Timer::REAL);
+        cout << "value " << solution.size() << "\ttime " << times[na] << endl;
+
+        if (polish > 0.0) {
+            CCLocalSearch search(graph, rnd);
+            search.load(solution);
+            search.onImprove = [&](int size) {
+                results[na] = size;
+                times[na] = timer.elapsed_time(Timer::REAL);
+                cout << "value " << size << "\ttime " << times[na] << endl;
+            };
+            double limit = timer.elapsed_time(Timer::REAL) + polish*time_limit;
+            search.run(timer, Timer::REAL, limit);
+            solution = search.best;
+        }
+        double ct = timer.elapsed_time(Timer::REAL);
+
+        unordered_set<int> set(solution.begin(), solution.end());
+        setNeighbor (neighbors);
+        if (not check_PIDS(set)) cout << "Error: solution is not a PIDS" << endl;
+
+        // the same time for one search on the whole graph
+        if (sequential) {
+            Timer seqTimer;
+            unordered_set<int> greedySolution = greedy();
+            CCLocalSearch search(graph, rnd);
+            search.load(vector<int>(greedySolution.begin(), greedySolution.end()));
+            search.run(seqTimer, Timer::REAL, ct);
+            cout << "sequential value " << search.best.size() << "\ttime " << ct;
+            cout << "\tquality loss " << 100.0*(double(solution.size()) - search.best.size())/search.best.size() << "%" << endl;
+        }
+
+        // speedup of the block phase: the same blocks and seeds for a fixed
+        // number of steps each, so every thread count does the same work
+        if (speedup_steps > 0 and workers > 1) {
+            vector< vector<int> > sol;
+            vector<double> cpu;
+            vector<int> sizes;
+            double base = 0.0;
+            for (int n = 1; ; n = min(2*n, workers)) {
+                double w = solveBlocks(partition, seeds, n, DBL_MAX, DBL_MAX, speedup_steps, sol, cpu, sizes);
+                if (n == 1) base = w;
+                cout << "speedup threads " << n << "\twall time " << w;
+                cout << "\tspeedup " << base/max(w, 1e-6) << endl;
+                if (n == workers) break;
+            }
+        }
+        cout << "end application " << na + 1 << endl;
+    }
+
+    // calculating the average of the results and computation times,
+    // and their standard deviations, and write them to the screen
+    double r_mean = 0.0;
+    int r_best = std::numeric_limits<int>::max();
+    double t_mean = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        r_mean = r_mean + results[i];
+        if (int(results[i]) < r_best) r_best = int(results[i]);
+        t_mean = t_mean + times[i];
+    }
+    r_mean = r_mean/double(results.size());
+    t_mean = t_mean/double(times.size());
+    double rsd = 0.0;
+    double tsd = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        rsd = rsd + pow(results[i]-r_mean,2.0);
+        tsd = tsd + pow(times[i]-t_mean,2.0);
+    }
+    rsd = rsd/double(results.size());
+    if (rsd > 0.0) {
+        rsd = sqrt(rsd);
+    }
+    tsd = tsd/double(results.size());
+    if (tsd > 0.0) {
+        tsd = sqrt(tsd);
+    }
+    // printing statistical information
+    cout << r_best << "\t" << r_mean << "\t" << rsd << "\t";
+    cout << t_mean << "\t" << tsd << endl;
+}
@@ -0,0 +1,107 @@
+#ifndef PARTITION_CLASS_CPP
+#define PARTITION_CLASS_CPP
+
+#include "pids_class.cpp"
+#include "Random.h"
+#include <vector>
+#include <unordered_set>
+#include <algorithm>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////
+//                      PARTITION                           //
+//////////////////////////////////////////////////////////////
+
+// Balanced partition of the graph into k blocks by label propagation.
+// The start cuts a breadth-first order from a random node into k chunks
+// of equal size, so blocks begin connected; then every round visits the
+// nodes in random order and moves each one to the block most of its
+// neighbors are in, if that block has room (at most imbalance n/k
+// nodes). It stops after a round without moves or after rounds rounds.
+struct Partition {
+    int k;
+    vector<int> block;           // block of every node
+    vector< vector<int> > nodes; // nodes of every block
+    long cut = 0;                // edges between blocks
+    int rounds = 0;              // rounds run
+
+    Partition(const Graph& g, int blocks, Random* rnd, double imbalance = 1.05, int max_rounds = 20)
+        : k(max(1, min(blocks, g.n))), block(g.n, 0) {
+        vector<int> order;
+        order.reserve(g.n);
+        vector<char> seen(g.n, 0);
+        int first = g.n > 0 ? int(rnd->next()*g.n) % g.n : 0;
+        for (int s = 0; s < g.n; s++) {
+            int root = (first + s) % g.n;
+            if (seen[root]) continue;
+            seen[root] = 1;
+            order.push_back(root);
+            for (size_t q = order.size() - 1; q < order.size(); q++)
+                for (const int* w = g.begin(order[q]); w != g.end(order[q]); ++w) {
+                    if (seen[*w]) continue;
+                    seen[*w] = 1;
+                    order.push_back(*w);
+                }
+        }
+        vector<int> size(k, 0);
+        for (int q = 0; q < g.n; q++) {
+            block[order[q]] = int((long(q)*k)/g.n);
+            size[block[order[q]]]++;
+        }
+
+        int capacity = int(imbalance*g.n/k) + 1;
+        vector<int> count(k, 0);
+        vector<int> touched;
+        for (rounds = 0; rounds < max_rounds; ) {
+            rounds++;
+            for (int q = g.n - 1; q > 0; q--) swap(order[q], order[int(rnd->next()*(q + 1)) % (q + 1)]);
+            int moves = 0;
+            for (int v : order) {
+                touched.clear();
+                for (const int* w = g.begin(v); w != g.end(v); ++w)
+                    if (count[block[*w]]++ == 0) touched.push_back(block[*w]);
+                int b = block[v];
+                int best = b;
+                for (int c : touched)
+                    if (count[c] > count[best] and size[c] < capacity) best = c;
+                for (int c : touched) count[c] = 0;
+                if (best == b) continue;
+                size[b]--;
+                size[best]++;
+                block[v] = best;
+                moves++;
+            }
+            if (moves == 0) break;
+        }
+
+        nodes.assign(k, vector<int>());
+        for (int v = 0; v < g.n; v++) {
+            nodes[block[v]].push_back(v);
+            for (const int* w = g.begin(v); w != g.end(v); ++w)
+                if (v < *w and block[v] != block[*w]) cut++;
+        }
+    }
+};
+
+// Subgraph induced by a block, local[v] being the index of node v in it.
+// The edges to other blocks are unknown to the block, so the threshold of
+// a boundary node is softened to its share of the edges left, rounded
+// down: need deg_block/deg. Rounding up overcounts once the blocks are
+// put together; what is missing is left to the repair after stitching
+Graph blockGraph(const Graph& g, const vector<int>& nodes, vector<int>& local) {
+    for (int a = 0; a < int(nodes.size()); a++) local[nodes[a]] = a;
+    vector< unordered_set<int> > nb(nodes.size());
+    for (int a = 0; a < int(nodes.size()); a++)
+        for (const int* w = g.begin(nodes[a]); w != g.end(nodes[a]); ++w)
+            if (local[*w] >= 0) nb[a].insert(local[*w]);
+    Graph sub = buildGraph(nb);
+    for (int a = 0; a < sub.n; a++) {
+        int v = nodes[a];
+        if (g.degree(v) > 0) sub.need[a] = int((long(g.need[v])*sub.degree(a))/g.degree(v));
+    }
+    for (int v : nodes) local[v] = -1;
+    return sub;
+}
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef PBLS_CLASS_CPP
+#define PBLS_CLASS_CPP
+
+#include "cover_class.cpp"
+#include "Random.h"
+#include "Timer.h"
+#include <vector>
+#include <climits>
+#include <functional>
+#include <cstdint>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////
+//              PSEUDO-BOOLEAN LOCAL SEARCH                 //
+//////////////////////////////////////////////////////////////
+
+// Incomplete solver for a CoverInstance read as a pseudo-Boolean problem,
+// in the style of SATLike and LS-PBO. It walks over all assignments,
+// feasible or not, and minimizes
+//     sum weight[i] max(0, rhs[i] - lhs[i]) + objWeight sum cost[j] x[j].
+// Each step flips the best of sampleSize sampled variables (best from
+// multiple selections) if that lowers the penalty. At a local minimum the
+// weights of the unmet rows grow, and so does objWeight while the current
+// cost is not below the best one; then the best column of a random unmet
+// row is set. A variable flipped in the last step is not flipped back.
+struct PBLocalSearch {
+    const CoverInstance& inst;
+    Random* rnd;
+    int sampleSize = 20;
+    int64_t objectiveLimit = 1000;
+
+    vector<char> x;
+    vector<int> lhs;
+    vector<int64_t> weight;
+    int64_t objWeight = 1;
+    vector<int> unmet;            // rows with lhs < rhs
+    vector<int> unmetPos;         // index of i in unmet, -1 if the row is met
+    vector<int> ones;             // variables set to 1
+    vector<int> onePos;
+    vector<int64_t> lastFlip;
+    long cost = 0;
+
+    vector<char> best;
+    long bestCost = LONG_MAX;
+    int64_t it = 0;
+
+    // called with the new best cost whenever it improves
+    function<void(long)> onImprove;
+
+    PBLocalSearch(const CoverInstance& instance, Random* r)
+        : inst(instance), rnd(r), x(instance.n_cols, 0), lhs(instance.n_rows, 0),
+          weight(instance.n_rows, 1), unmetPos(instance.n_rows, -1),
+          onePos(instance.n_cols, -1), lastFlip(instance.n_cols, -2) {
+        for (int i = 0; i < inst.n_rows; i++)
+            if (inst.rhs[i] > 0) setUnmet(i, true);
+    }
+
+    // Start from the given variables set to 1
+    void load(const vector<int>& start) {
+        for (int j : start)
+            if (not x[j]) flip(j);
+    }
+
+    // Change of the penalty when j is flipped, positive if it drops
+    int64_t score(int j) const {
+        int d = x[j] ? -1 : 1;
+        int64_t s = -int64_t(d)*objWeight*inst.cost[j];
+        for (int k = inst.colStart[j]; k < inst.colStart[j + 1]; k++) {
+            int i = inst.colRow[k];
+            int before = max(0, inst.rhs[i] - lhs[i]);
+            int after = max(0, inst.rhs[i] - lhs[i] - d*inst.colCoef[k]);
+            s += weight[i]*(before - after);
+        }
+        return s;
+    }
+
+    void flip(int j) {
+        int d = x[j] ? -1 : 1;
+        x[j] = !x[j];
+        cost += d*inst.cost[j];
+        lastFlip[j] = it;
+        if (x[j]) {
+            onePos[j] = ones.size();
+            ones.push_back(j);
+        }
+        else {
+            int last = ones.back();
+            ones[onePos[j]] = last;
+            onePos[last] = onePos[j];
+            ones.pop_back();
+            onePos[j] = -1;
+        }
+        for (int k = inst.colStart[j]; k < inst.colStart[j + 1]; k++) {
+            int i = inst.colRow[k];
+            lhs[i] += d*inst.colCoef[k];
+            setUnmet(i, lhs[i] < inst.rhs[i]);
+        }
+    }
+
+    // Search for at most max_steps steps (-1 for no limit) or until the
+    // clock passes limit; best holds the cheapest feasible assignment
+    void run(Timer& timer, Timer::TYPE clock, double limit, int64_t max_steps = -1) {
+        int64_t end = max_steps < 0 ? INT64_MAX : it + max_steps;
+        while (it < end) {
+            if ((it & 255) == 0 and timer.elapsed_time(clock) > limit) break;
+            it++;
+            if (unmet.empty() and cost < bestCost) {
+                bestCost = cost;
+                best = x;
+                if (onImprove) onImprove(bestCost);
+            }
+
+            // best from multiple selections: members, and columns of unmet rows
+            int pick = -1;
+            int64_t pickScore = 0;
+            for (int t = 0; t < sampleSize; t++) {
+                int j;
+                if (unmet.empty() or (t & 1)) {
+                    if (ones.empty()) continue;
+                    j = ones[int(rnd->next()*ones.size()) % ones.size()];
+                }
+                else {
+                    int i = unmet[int(rnd->next()*unmet.size()) % unmet.size()];
+                    int len = inst.rowStart[i + 1] - inst.rowStart[i];
+                    j = inst.rowCol[inst.rowStart[i] + int(rnd->next()*len) % len];
+                }
+                if (lastFlip[j] == it - 1) continue;
+                int64_t s = score(j);
+                if (s > pickScore or (s == pickScore and pick >= 0 and lastFlip[j] < lastFlip[pick])) {
+                    pick = j;
+                    pickScore = s;
+                }
+            }
+            if (pick >= 0) {
+                flip(pick);
+                continue;
+            }
+
+            // local minimum: update the weights and meet a random unmet row
+            for (int i : unmet) weight[i]++;
+            if (cost >= bestCost and objWeight < objectiveLimit) objWeight++;
+            if (unmet.empty()) {
+                // feasible and locally minimal: drop the best sampled member
+                for (int t = 0; t < sampleSize and not ones.empty(); t++) {
+                    int j = ones[int(rnd->next()*ones.size()) % ones.size()];
+                    int64_t s = score(j);
+                    if (pick < 0 or s > pickScore) {
+                        pick = j;
+                        pickScore = s;
+                    }
+                }
+                if (pick >= 0) flip(pick);
+                continue;
+            }
+            int i = unmet[int(rnd->next()*unmet.size()) % unmet.size()];
+            for (int k = inst.rowStart[i]; k < inst.rowStart[i + 1]; k++) {
+                int j = inst.rowCol[k];
+                if (x[j]) continue;
+                int64_t s = score(j);
+                if (pick < 0 or s > pickScore or (s == pickScore and lastFlip[j] < lastFlip[pick])) {
+                    pick = j;
+                    pickScore = s;
+                }
+            }
+            if (pick >= 0) flip(pick);
+        }
+    }
+
+private:
+    void setUnmet(int i, bool on) {
+        if (on == (unmetPos[i] >= 0)) return;
+        if (on) {
+            unmetPos[i] = unmet.size();
+            unmet.push_back(i);
+        }
+        else {
+            int last = unmet.back();
+            unmet[unmetPos[i]] = last;
+            unmetPos[last] = unmetPos[i];
+            unmet.pop_back();
+            unmetPos[i] = -1;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,225 @@
+#ifndef PIDS_CLASS_CPP
+#define PIDS_CLASS_CPP
+
+#include <vector>
+#include <unordered_set>
+#include <algorithm>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////
+//                         GRAPH                            //
+//////////////////////////////////////////////////////////////
+
+// Compressed adjacency of the input graph. need[v] is the number of
+// neighbors of v that have to be in the solution, i.e. ceil(deg(v)/2)
+struct Graph {
+    int n = 0;
+    long m = 0;
+    vector<int> start;
+    vector<int> adj;
+    vector<int> need;
+
+    int degree(int v) const { return start[v + 1] - start[v]; }
+    const int* begin(int v) const { return adj.data() + start[v]; }
+    const int* end(int v) const { return adj.data() + start[v + 1]; }
+};
+
+Graph buildGraph(const vector< unordered_set<int> >& nb) {
+    Graph g;
+    g.n = nb.size();
+    g.start.assign(g.n + 1, 0);
+    for (int v = 0; v < g.n; v++) g.start[v + 1] = g.start[v] + nb[v].size();
+    g.adj.resize(g.start[g.n]);
+    g.need.resize(g.n);
+    for (int v = 0; v < g.n; v++) {
+        int k = g.start[v];
+        for (int u : nb[v]) g.adj[k++] = u;
+        sort(g.adj.begin() + g.start[v], g.adj.begin() + g.start[v + 1]);
+        g.need[v] = (nb[v].size() + 1)/2;
+    }
+    g.m = g.start[g.n]/2;
+    return g;
+}
+
+
+//////////////////////////////////////////////////////////////
+//                    SOLUTION STATE                        //
+//////////////////////////////////////////////////////////////
+
+// Solution with all the counters needed to evaluate moves in O(deg).
+// A node x is critical when popularity[x] <= need[x], so removing any
+// member next to it breaks (or keeps broken) its threshold.
+struct PIDSState {
+    const Graph* g = nullptr;
+    vector<char> in;
+    vector<int> popularity;        // members among the neighbors of v
+    vector<int> critical;          // critical neighbors of v
+    vector<long long> criticalSum; // sum of the ids of the critical neighbors of v
+    vector<int> members;
+    vector<int> pos;               // index of v in members, -1 if v is not a member
+    long deficit = 0;              // sum of max(0, need[v] - popularity[v])
+
+    // if set, nodes whose critical counter changed are appended here
+    vector<int>* touched = nullptr;
+    // if set, every move is appended here (v for an add, ~v for a removal)
+    vector<int>* trail = nullptr;
+
+    void init(const Graph& graph) {
+        g = &graph;
+        in.assign(g->n, 0);
+        popularity.assign(g->n, 0);
+        critical.assign(g->n, 0);
+        criticalSum.assign(g->n, 0);
+        members.clear();
+        pos.assign(g->n, -1);
+        deficit = 0;
+        for (int x = 0; x < g->n; x++) {
+            deficit += g->need[x];
+            for (const int* it = g->begin(x); it != g->end(x); ++it) {
+                critical[*it]++;
+                criticalSum[*it] += x;
+            }
+        }
+    }
+
+    template <class Container>
+    void load(const Container& solution) {
+        vector<int>* t = touched;
+        vector<int>* tr = trail;
+        touched = trail = nullptr;
+        init(*g);
+        for (int v : solution) add(v);
+        touched = t;
+        trail = tr;
+    }
+
+    unordered_set<int> toSet() const {
+        return unordered_set<int>(members.begin(), members.end());
+    }
+
+    int size() const { return members.size(); }
+    bool feasible() const { return deficit == 0; }
+    int slack(int v) const { return popularity[v] - g->need[v]; }
+    bool isCritical(int v) const { return popularity[v] <= g->need[v]; }
+    bool removable(int v) const { return in[v] and critical[v] == 0; }
+
+    // The only critical neighbor of v, valid when critical[v] == 1
+    int soleCritical(int v) const { return int(criticalSum[v]); }
+
+    void add(int v) {
+        in[v] = 1;
+        pos[v] = members.size();
+        members.push_back(v);
+        if (trail) trail->push_back(v);
+        if (touched) touched->push_back(v);
+        for (const int* it = g->begin(v); it != g->end(v); ++it) {
+            int x = *it;
+            if (popularity[x] < g->need[x]) deficit--;
+            popularity[x]++;
+            if (popularity[x] == g->need[x] + 1) setCritical(x, -1);
+        }
+    }
+
+    void remove(int v) {
+        in[v] = 0;
+        int last = members.back();
+        members[pos[v]] = last;
+        pos[last] = pos[v];
+        members.pop_back();
+        pos[v] = -1;
+        if (trail) trail->push_back(~v);
+        if (touched) touched->push_back(v);
+        for (const int* it = g->begin(v); it != g->end(v); ++it) {
+            int x = *it;
+            popularity[x]--;
+            if (popularity[x] < g->need[x]) deficit++;
+            if (popularity[x] == g->need[x]) setCritical(x, 1);
+        }
+    }
+
+    // Undo the moves recorded in the trail after position mark
+    void rollback(size_t mark) {
+        vector<int>* t = trail;
+        trail = nullptr;
+        while (t->size() > mark) {
+            int mv = t->back();
+            t->pop_back();
+            if (mv >= 0) remove(mv);
+            else add(~mv);
+        }
+        trail = t;
+    }
+
+    // Add nodes until every threshold is met. Each deficient node x takes
+    // the non-member neighbor with the most deficient neighbors
+    int repair() {
+        int added = 0;
+        for (int x = 0; x < g->n and deficit > 0; x++) added += repairNode(x);
+        return added;
+    }
+
+    // Same as repair() when only the nodes in cand can be deficient
+    int repair(const vector<int>& cand) {
+        int added = 0;
+        for (int x : cand) added += repairNode(x);
+        return added;
+    }
+
+    // Remove the members in cand that are redundant, in the given order
+    int prune(const vector<int>& cand) {
+        int removed = 0;
+        for (int v : cand) {
+            if (removable(v)) {
+                remove(v);
+                removed++;
+            }
+        }
+        return removed;
+    }
+
+    // Remove redundant members, lowest degree first as remove_nodes does
+    int pruneAll() {
+        vector<int> cand;
+        for (int v : members)
+            if (critical[v] == 0) cand.push_back(v);
+        sort(cand.begin(), cand.end(), [&](int a, int b) {
+            if (g->degree(a) != g->degree(b)) return g->degree(a) < g->degree(b);
+            return a < b;
+        });
+        return prune(cand);
+    }
+
+private:
+    int repairNode(int x) {
+        int added = 0;
+        while (popularity[x] < g->need[x]) {
+            int best = -1;
+            int bestCount = -1;
+            for (const int* it = g->begin(x); it != g->end(x); ++it) {
+                int w = *it;
+                if (in[w]) continue;
+                int count = 0;
+                for (const int* jt = g->begin(w); jt != g->end(w); ++jt)
+                    if (popularity[*jt] < g->need[*jt]) count++;
+                if (count > bestCount) {
+                    best = w;
+                    bestCount = count;
+                }
+            }
+            add(best);
+            added++;
+        }
+        return added;
+    }
+
+    void setCritical(int x, int d) {
+        for (const int* it = g->begin(x); it != g->end(x); ++it) {
+            critical[*it] += d;
+            criticalSum[*it] += d*x;
+            if (touched) touched->push_back(*it);
+        }
+    }
+};
+
+#endif
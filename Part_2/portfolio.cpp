@@ -0,0 +1,392 @@
+/***************************************************************************
+    portfolio.cpp
+    (C) 2021 by C. Blum & M. Blesa
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Timer.h"
+#include "Random.h"
+#include "../Part_1/greedy_class.cpp"
+#include "pids_class.cpp"
+#include "tabu_class.cpp"
+#include "ccls_class.cpp"
+#include "sa_class.cpp"
+#include "elite_class.cpp"
+#include "bound_class.cpp"
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include <limits>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+// global variables concerning the random number generator (in case needed)
+time_t t;
+Random* rnd;
+
+// Data structures for the problem data
+int n_of_nodes;
+int n_of_arcs;
+vector< unordered_set<int> > neighbors;
+Graph graph;
+
+// string for keeping the name of the input file
+string inputFile;
+
+// computing time limit for each application of the portfolio
+double time_limit = 600.0;
+
+// number of applications of the portfolio
+int n_apps = 1;
+
+// one thread per entry, each with its own generator:
+//   greedy  randomized greedy constructions from scratch
+//   ig      iterated greedy: destroy part of the incumbent and repair it
+//   sa      simulated annealing (sa_class.cpp)
+//   tabu    incremental tabu search (tabu_class.cpp)
+//   ccls    configuration checking local search (ccls_class.cpp)
+string solver_list = "greedy,ig,sa,tabu,ccls";
+const vector<string> known_solvers = {"greedy", "ig", "sa", "tabu", "ccls"};
+
+// an application stops once a solution of <target> nodes is found
+int target = 0;
+
+// a tabu or ccls worker that does not improve for <stagnation> steps
+// takes the incumbent if it is better than its own best
+int64_t stagnation = 100000;
+
+// passes of the LP lower bound printed next to every result, 0 to skip it
+int lb_iterations = 500;
+
+
+void read_parameters(int argc, char **argv) {
+
+    int iarg = 1;
+    while (iarg < argc) {
+        if (strcmp(argv[iarg],"-i") == 0) inputFile = argv[++iarg];
+        // reading the computation time limit
+        // from the command line (if provided)
+        else if (strcmp(argv[iarg],"-t") == 0) time_limit = atoi(argv[++iarg]);
+        // reading the number of applications of the metaheuristic
+        // from the command line (if provided)
+        else if (strcmp(argv[iarg],"-n_apps") == 0) n_apps = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-solvers") == 0) solver_list = argv[++iarg];
+        else if (strcmp(argv[iarg],"-target") == 0) target = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-stagnation") == 0) stagnation = atoll(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-lb") == 0) lb_iterations = atoi(argv[++iarg]);
+        iarg++;
+    }
+}
+
+//Remove k random members and make the solution feasible again, the
+//deficient nodes taken in random order
+void destroyRepair(PIDSState& state, Random* r, int k) {
+    for (int i = 0; i < k and state.size() > 0; i++)
+        state.remove(state.members[int(r->next()*state.size()) % state.size()]);
+    vector<int> order(graph.n);
+    for (int v = 0; v < graph.n; v++) order[v] = v;
+    for (int v = graph.n - 1; v > 0; v--) swap(order[v], order[int(r->next()*(v + 1)) % (v + 1)]);
+    state.repair(order);
+    state.pruneAll();
+}
+
+//////////////////////////////////////////////////////////////
+//                       PORTFOLIO                          //
+//////////////////////////////////////////////////////////////
+
+// Every worker runs one solver of the list in its own thread on the
+// shared graph. The incumbent is the best entry of an ElitePool, which
+// is updated with compare-and-swap, so publishing and reading it never
+// blocks a worker. Workers offer every solution that beats the incumbent
+// and, when they stall, continue from the incumbent if it beats their
+// own best (an import). The application ends at the time limit or once
+// the incumbent reaches the target.
+struct Portfolio {
+    vector<string> solvers;
+    vector<Random> streams;
+    ElitePool pool;
+    // Timer is not safe to share, so every worker reads its own clock,
+    // started with the portfolio <offset> seconds into the application
+    vector<Timer> clocks;
+    double offset;
+    atomic<bool> stop;
+    vector<int64_t> steps;
+    vector<int> improvements;
+    vector<int> imports;
+
+    Portfolio(const vector<string>& names, Timer& tm, const vector<int>& start)
+        : solvers(names), pool(2*names.size()), clocks(names.size()), offset(tm.elapsed_time(Timer::REAL)), stop(false),
+          steps(names.size(), 0), improvements(names.size(), 0), imports(names.size(), 0) {
+        // fresh seeds from the main generator in every application
+        for (int w = 0; w < int(names.size()); w++) streams.push_back(Random(int(rnd->next()*2147483646) + 1));
+        pool.push(start, -1, offset);
+    }
+
+    // time of the application as seen by worker w
+    double now(int w) { return offset + clocks[w].elapsed_time(Timer::REAL); }
+
+    bool done(int w) {
+        if (not stop and now(w) > time_limit) stop = true;
+        return stop;
+    }
+
+    void offer(const vector<int>& members, int w) {
+        if (int(members.size()) >= pool.bestSize()) return;
+        if (pool.push(members, w, now(w))) improvements[w]++;
+        if (target > 0 and pool.bestSize() <= target) stop = true;
+    }
+
+    // incumbent members if it beats own, empty otherwise
+    vector<int> importIfBetter(int own, int w) {
+        vector<int> members;
+        if (pool.bestSize() >= own or not pool.copyBest(members) or int(members.size()) >= own)
+            return vector<int>();
+        imports[w]++;
+        return members;
+    }
+
+    void run() {
+        vector<thread> threads;
+        for (int w = 0; w < int(solvers.size()); w++) threads.push_back(thread(&Portfolio::worker, this, w));
+        for (thread& th : threads) th.join();
+    }
+
+    void worker(int w) {
+        Random& r = streams[w];
+        const string& name = solvers[w];
+        PIDSState state;
+        state.init(graph);
+        vector<int> incumbent;
+        pool.copyBest(incumbent);
+        state.load(incumbent);
+
+        if (name == "greedy" or name == "ig") {
+            while (not done(w)) {
+                if (name == "greedy") {
+                    state.init(graph);
+                    destroyRepair(state, &r, 0);
+                }
+                else {
+                    vector<int> inc = importIfBetter(state.size(), w);
+                    if (not inc.empty()) state.load(inc);
+                    vector<int> keep = state.members;
+                    destroyRepair(state, &r, 1 + int(r.next()*state.size()/10));
+                    if (state.size() > int(keep.size())) state.load(keep);
+                }
+                offer(state.members, w);
+                steps[w]++;
+            }
+        }
+        else if (name == "sa") {
+            AnnealingEngine sa(state, &r);
+            sa.onImprove = [&](int) { offer(sa.best, w); };
+            while (not done(w)) {
+                int reheats = sa.reheats;
+                sa.run(clocks[w], Timer::REAL, time_limit - offset, 10000);
+                if (sa.reheats > reheats) {
+                    // reheated: start the new cycle from the incumbent if better
+                    vector<int> inc = importIfBetter(sa.best.size(), w);
+                    if (not inc.empty()) sa.restart(inc);
+                }
+            }
+            steps[w] = sa.it;
+        }
+        else if (name == "tabu") {
+            int64_t base = 10 + graph.n/100;
+            int64_t tenure = base/2 + base*(w % 4)/3;
+            while (not done(w)) {
+                TabuEngine tabu(state, &r, tenure, tenure);
+                int64_t lastImprovement = 0;
+                tabu.onImprove = [&](int) {
+                    lastImprovement = tabu.it;
+                    offer(state.members, w);
+                };
+                while (tabu.it - lastImprovement < stagnation) {
+                    if ((tabu.it & 255) == 0 and done(w)) break;
+                    if (not tabu.step()) break;
+                }
+                steps[w] += tabu.it;
+                tabu.restoreBest();
+                if (done(w)) break;
+                vector<int> inc = importIfBetter(state.size(), w);
+                if (not inc.empty()) state.load(inc);
+                else destroyRepair(state, &r, 1 + state.size()/50);
+            }
+        }
+        else if (name == "ccls") {
+            vector<int> start = state.members;
+            while (not done(w)) {
+                CCLocalSearch search(graph, &r);
+                search.load(start);
+                int64_t lastImprovement = 0;
+                search.onImprove = [&](int) {
+                    lastImprovement = search.it;
+                    offer(search.best, w);
+                };
+                while (search.it - lastImprovement < stagnation and not done(w)) {
+                    int64_t it0 = search.it;
+                    search.run(clocks[w], Timer::REAL, time_limit - offset, 4096);
+                    if (search.it == it0) break;
+                }
+                steps[w] += search.it;
+                vector<int> inc = importIfBetter(search.best.size(), w);
+                start = inc.empty() ? search.best : inc;
+            }
+        }
+    }
+};
+
+/**********
+Main function
+**********/
+
+int main( int argc, char **argv ) {
+
+    read_parameters(argc,argv);
+
+    // setting the output format for doubles to 2 decimals after the comma
+    std::cout << std::setprecision(2) << std::fixed;
+
+    // initializing the random number generator. A random number
+    // between 0 and 1 is obtained with: double rnum = rnd->next();
+    rnd = new Random((unsigned) time(&t));
+    rnd->next();
+
+    vector<string> solvers;
+    stringstream list(solver_list);
+    string name;
+    while (getline(list, name, ','))
+        if (not name.empty()) solvers.push_back(name);
+    for (const string& s : solvers)
+        if (find(known_solvers.begin(), known_solvers.end(), s) == known_solvers.end()) {
+            cout << "Error: unknown solver " << s << endl;
+            return 1;
+        }
+    if (solvers.empty()) {
+        cout << "Error: no solver given" << endl;
+        return 1;
+    }
+
+    // vectors for storing the result and the computation time
+    // obtained by the <n_apps> applications of the portfolio
+    vector<double> results(n_apps, std::numeric_limits<int>::max());
+    vector<double> times(n_apps, 0.0);
+
+    // opening the corresponding input file and reading the problem data
+    ifstream indata;
+    indata.open(inputFile.c_str());
+    if (not indata) { // file couldn't be opened
+        cout << "Error: file could not be opened" << endl;
+    }
+
+    indata >> n_of_nodes;
+    indata >> n_of_arcs;
+    neighbors = vector< unordered_set<int> >(n_of_nodes);
+    int u, v;
+    while (indata >> u >> v) {
+        neighbors[u - 1].insert(v - 1);
+        neighbors[v - 1].insert(u - 1);
+    }
+    indata.close();
+    graph = buildGraph(neighbors);
+
+    // certified lower bound from the LP relaxation
+    int lower_bound = lpLowerBound(graph, lb_iterations);
+
+    setNeighbor (neighbors);
+
+    // main loop over all applications of the portfolio
+    for (int na = 0; na < n_apps; ++na) {
+
+        // the computation time starts now; wall-clock time, the workers
+        // run in parallel
+        Timer timer;
+
+        cout << "start application " << na + 1 << endl;
+
+        PIDSState state;
+        state.init(graph);
+        state.repair();
+        state.pruneAll();
+        cout << "value " << state.size() << "\ttime " << timer.elapsed_time(Timer::REAL) << "\tsolver start" << endl;
+
+        Portfolio portfolio(solvers, timer, state.members);
+        portfolio.run();
+
+        // best value over time and the solver that found it
+        ElitePool& pool = portfolio.pool;
+        results[na] = state.size();
+        for (const ElitePool::TracePoint& p : pool.timeline()) {
+            if (p.worker < 0) continue;
+            cout << "value " << p.size << "\ttime " << p.time << "\tsolver " << solvers[p.worker] << endl;
+            results[na] = p.size;
+            times[na] = p.time;
+        }
+        for (int w = 0; w < int(solvers.size()); w++) {
+            cout << "worker " << w << "\tsolver " << solvers[w] << "\tsteps " << portfolio.steps[w];
+            cout << "\timprovements " << portfolio.improvements[w] << "\timports " << portfolio.imports[w] << endl;
+        }
+
+        vector<int> best;
+        pool.copyBest(best);
+        unordered_set<int> solution(best.begin(), best.end());
+        if (not check_PIDS(solution)) cout << "Error: solution is not a PIDS" << endl;
+
+        printGap(lower_bound, results[na]);
+        cout << "end application " << na + 1 << endl;
+    }
+
+    // calculating the average of the results and computation times,
+    // and their standard deviations, and write them to the screen
+    double r_mean = 0.0;
+    int r_best = std::numeric_limits<int>::max();
+    double t_mean = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        r_mean = r_mean + results[i];
+        if (int(results[i]) < r_best) r_best = int(results[i]);
+        t_mean = t_mean + times[i];
+    }
+    r_mean = r_mean/double(results.size());
+    t_mean = t_mean/double(times.size());
+    double rsd = 0.0;
+    double tsd = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        rsd = rsd + pow(results[i]-r_mean,2.0);
+        tsd = tsd + pow(times[i]-t_mean,2.0);
+    }
+    rsd = rsd/double(results.size());
+    if (rsd > 0.0) {
+        rsd = sqrt(rsd);
+    }
+    tsd = tsd/double(results.size());
+    if (tsd > 0.0) {
+        tsd = sqrt(tsd);
+    }
+    // printing statistical information
+    cout << r_best << "\t" << r_mean << "\t" << rsd << "\t";
+    cout << t_mean << "\t" << tsd << endl;
+}
@@ -0,0 +1,146 @@
+#ifndef SA_CLASS_CPP
+#define SA_CLASS_CPP
+
+#include "pids_class.cpp"
+#include "Random.h"
+#include "Timer.h"
+#include <vector>
+#include <cmath>
+#include <functional>
+#include <cstdint>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////
+//                  SIMULATED ANNEALING                     //
+//////////////////////////////////////////////////////////////
+
+// Simulated annealing over feasible solutions. A move drops a random
+// member v, repairs the neighbors of v left deficient without taking v
+// back (each takes the non-member neighbor with the most deficient
+// neighbors) and prunes the members that became redundant around the
+// nodes added. The change of size is accepted with the Metropolis rule
+// at the current temperature, otherwise the move is undone from the
+// trail. The temperature drops by alpha every cycle moves; once below
+// minTemperature the search reheats from the best solution.
+// Nodes of degree above scanLimit are not scanned for redundant members.
+struct AnnealingEngine {
+    PIDSState& s;
+    Random* rnd;
+    double startTemperature;
+    double alpha;
+    double minTemperature = 0.05;
+    int64_t cycle;
+    int scanLimit = 256;
+
+    double temperature;
+    vector<int> trail;
+    vector<int> added;
+    vector<int> cand;
+    vector<int> seen;
+    int stamp = 0;
+
+    vector<int> best;
+    int64_t it = 0;
+    int64_t accepted = 0;
+    int reheats = 0;
+
+    // called with the new best size whenever it improves
+    function<void(int)> onImprove;
+
+    AnnealingEngine(PIDSState& state, Random* r, double t0 = 1.0, double a = 0.95, int64_t moves = 1000)
+        : s(state), rnd(r), startTemperature(t0), alpha(a), cycle(moves), temperature(t0),
+          seen(state.g->n, 0), best(state.members) {
+        s.trail = &trail;
+    }
+
+    ~AnnealingEngine() { s.trail = nullptr; }
+
+    // Continue from another solution, e.g. an incumbent found elsewhere
+    void restart(const vector<int>& members) {
+        s.load(members);
+        trail.clear();
+        best = s.members;
+        temperature = startTemperature;
+    }
+
+    // One move, false if the solution is empty
+    bool step() {
+        const Graph& g = *s.g;
+        if (s.size() == 0) return false;
+        int before = s.size();
+        int v = s.members[int(rnd->next()*s.size()) % s.size()];
+        s.remove(v);
+        added.clear();
+        for (const int* x = g.begin(v); x != g.end(v); ++x) {
+            while (s.popularity[*x] < g.need[*x]) {
+                int pick = -1;
+                int pickCount = -1;
+                int d = g.degree(*x);
+                int first = int(rnd->next()*d) % d;
+                for (int k = 0; k < d; k++) {
+                    int w = g.begin(*x)[(first + k) % d];
+                    if (s.in[w] or w == v) continue;
+                    int count = 0;
+                    for (const int* y = g.begin(w); y != g.end(w); ++y)
+                        count += s.popularity[*y] < g.need[*y];
+                    if (count > pickCount) {
+                        pick = w;
+                        pickCount = count;
+                    }
+                }
+                // v was the only way left to meet the threshold of x
+                if (pick < 0) pick = v;
+                s.add(pick);
+                added.push_back(pick);
+            }
+        }
+
+        stamp++;
+        cand.clear();
+        for (int w : added)
+            for (const int* x = g.begin(w); x != g.end(w); ++x) {
+                if (g.degree(*x) > scanLimit) continue;
+                for (const int* y = g.begin(*x); y != g.end(*x); ++y)
+                    if (s.in[*y] and seen[*y] != stamp) {
+                        seen[*y] = stamp;
+                        cand.push_back(*y);
+                    }
+            }
+        for (int k = int(cand.size()) - 1; k > 0; k--) swap(cand[k], cand[int(rnd->next()*(k + 1)) % (k + 1)]);
+        s.prune(cand);
+
+        int delta = s.size() - before;
+        if (delta <= 0 or rnd->next() < exp(-delta/temperature)) {
+            accepted++;
+            trail.clear();
+            if (s.size() < int(best.size())) {
+                best = s.members;
+                if (onImprove) onImprove(best.size());
+            }
+        }
+        else s.rollback(0);
+
+        it++;
+        if (it % cycle == 0) {
+            temperature *= alpha;
+            if (temperature < minTemperature) {
+                reheats++;
+                restart(best);
+            }
+        }
+        return true;
+    }
+
+    // Search until the clock passes limit or for max_moves moves (-1 for
+    // no limit); best holds the smallest PIDS
+    int run(Timer& timer, Timer::TYPE clock, double limit, int64_t max_moves = -1) {
+        for (int64_t k = 0; max_moves < 0 or k < max_moves; k++) {
+            if ((k & 255) == 0 and timer.elapsed_time(clock) > limit) break;
+            if (not step()) break;
+        }
+        return best.size();
+    }
+};
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef SWAP_CLASS_CPP
+#define SWAP_CLASS_CPP
+
+#include "pids_class.cpp"
+#include "Random.h"
+
+//////////////////////////////////////////////////////////////
+//                    ONE-TIGHT INDEX                       //
+//////////////////////////////////////////////////////////////
+
+// A member u is one-tight when exactly one of its neighbors, x, is
+// critical. Adding any non-member w next to x makes u redundant, so
+// lists[x] holds the members that a new node next to x would free.
+// refresh() has to be called for every node the state reports as
+// touched; the nodes whose list changed are appended to changed.
+struct OneTightIndex {
+    const PIDSState& s;
+    vector<int> tightOf;              // critical neighbor of a one-tight member, -1 otherwise
+    vector< vector<int> > lists;
+    vector<int> pos;
+    vector<int> changed;
+
+    OneTightIndex(const PIDSState& state) : s(state) {
+        int n = s.g->n;
+        tightOf.assign(n, -1);
+        lists.assign(n, vector<int>());
+        pos.assign(n, -1);
+        for (int v : s.members) refresh(v);
+    }
+
+    void refresh(int u) {
+        int x = (s.in[u] and s.critical[u] == 1) ? s.soleCritical(u) : -1;
+        if (x == tightOf[u]) return;
+        if (tightOf[u] >= 0) {
+            vector<int>& l = lists[tightOf[u]];
+            int p = pos[u];
+            l[p] = l.back();
+            pos[l[p]] = p;
+            l.pop_back();
+            changed.push_back(tightOf[u]);
+        }
+        tightOf[u] = x;
+        if (x >= 0) {
+            pos[u] = lists[x].size();
+            lists[x].push_back(u);
+            changed.push_back(x);
+        }
+    }
+};
+
+
+//////////////////////////////////////////////////////////////
+//                    SWAP NEIGHBORHOODS                    //
+//////////////////////////////////////////////////////////////
+
+// Improvement and plateau phase built on (k,1) and (1,1) swaps.
+// A (k,1) swap adds a node w and removes k >= 2 of the members it frees;
+// a (1,1) swap adds w and removes one of them, moving along the plateau.
+struct SwapEngine {
+    PIDSState& s;
+    Random* rnd;
+    int tenure;
+
+    vector<int> touched;
+    OneTightIndex index;
+    vector<int> queue;                // critical nodes to scan for (k,1) swaps
+    vector<char> queued;
+    vector<int> mark;
+    int stamp = 0;
+    vector<long> tabuUntil;           // plateau moves may not undo a recent move
+    long it = 0;
+
+    long kSwaps = 0;
+    long plateauSwaps = 0;
+
+    SwapEngine(PIDSState& state, Random* r, int tabuTenure = 7)
+        : s(state), rnd(r), tenure(tabuTenure), index(state) {
+        int n = s.g->n;
+        queued.assign(n, 0);
+        mark.assign(n, 0);
+        tabuUntil.assign(n, 0);
+        s.touched = &touched;
+        sync();
+    }
+
+    ~SwapEngine() { s.touched = nullptr; }
+
+    // Apply (k,1) swaps and prune redundant members until no more apply
+    int improve() {
+        int gained = s.pruneAll();
+        sync();
+        while (not queue.empty()) {
+            int x = queue.back();
+            queue.pop_back();
+            queued[x] = 0;
+            if (s.isCritical(x) and not index.lists[x].empty()) gained += swapAround(x);
+            sync();
+        }
+        return gained;
+    }
+
+    // One (1,1) swap chosen at random, false if none was found
+    bool plateauMove() {
+        int n_members = s.members.size();
+        for (int tries = 0; tries < 32 and n_members > 0; tries++) {
+            int u = s.members[int(rnd->next()*n_members) % n_members];
+            int x = index.tightOf[u];
+            if (x < 0 or tabuUntil[u] > it) continue;
+            int deg = s.g->degree(x);
+            const int* nb = s.g->begin(x);
+            int first = int(rnd->next()*deg) % deg;
+            for (int k = 0; k < deg; k++) {
+                int w = nb[(first + k) % deg];
+                if (s.in[w] or tabuUntil[w] > it) continue;
+                s.add(w);
+                s.remove(u);
+                queueAround(u);
+                tabuUntil[u] = tabuUntil[w] = it + tenure;
+                it++;
+                plateauSwaps++;
+                sync();
+                return true;
+            }
+        }
+        it++;
+        return false;
+    }
+
+    // improve() followed by n_moves plateau moves, each one followed by
+    // another improvement pass. The size never increases.
+    int run(long n_moves) {
+        improve();
+        for (long k = 0; k < n_moves; k++) {
+            if (plateauMove()) improve();
+        }
+        return s.size();
+    }
+
+private:
+    // Try to add a non-member next to x and drop at least two members
+    int swapAround(int x) {
+        for (const int* it = s.g->begin(x); it != s.g->end(x); ++it) {
+            int w = *it;
+            if (s.in[w]) continue;
+
+            // members freed by adding w
+            vector<int> freed;
+            stamp++;
+            for (const int* jt = s.g->begin(w); jt != s.g->end(w); ++jt) {
+                int y = *jt;
+                if (not s.isCritical(y)) continue;
+                for (int u : index.lists[y]) {
+                    if (mark[u] != stamp) {
+                        mark[u] = stamp;
+                        freed.push_back(u);
+                    }
+                }
+            }
+            if (freed.size() < 2) continue;
+
+            s.add(w);
+            int removed = s.prune(freed);
+            if (removed >= 2) {
+                for (int u : freed)
+                    if (not s.in[u]) queueAround(u);
+                kSwaps++;
+                return removed - 1;
+            }
+            // undo, the swap would not reduce the size
+            if (removed == 1) {
+                for (int u : freed) {
+                    if (not s.in[u]) {
+                        s.add(u);
+                        break;
+                    }
+                }
+            }
+            s.remove(w);
+        }
+        return 0;
+    }
+
+    // u left the solution, so it is a candidate next to its critical neighbors
+    void queueAround(int u) {
+        for (const int* it = s.g->begin(u); it != s.g->end(u); ++it) {
+            int x = *it;
+            if (s.isCritical(x) and not index.lists[x].empty()) push(x);
+        }
+    }
+
+    void push(int x) {
+        if (not queued[x]) {
+            queued[x] = 1;
+            queue.push_back(x);
+        }
+    }
+
+    void sync() {
+        for (size_t k = 0; k < touched.size(); k++) index.refresh(touched[k]);
+        touched.clear();
+        for (int x : index.changed)
+            if (not index.lists[x].empty()) push(x);
+        index.changed.clear();
+    }
+};
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef SYMMETRY_CLASS_CPP
+#define SYMMETRY_CLASS_CPP
+
+#include "pids_class.cpp"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <algorithm>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////
+//                        TWINS                             //
+//////////////////////////////////////////////////////////////
+
+// Classes of twins: false twins have the same neighbors (N(u) = N(v)),
+// true twins the same closed neighborhood (N[u] = N[v]). Swapping two
+// twins maps every PIDS to a PIDS of the same size, so any class can be
+// ordered: x[first] >= ... >= x[last] keeps one of the optimal solutions.
+// next[v] and prev[v] chain each class by increasing node id, -1 at the
+// ends and for the nodes without twins.
+struct TwinClasses {
+    vector<int> next;
+    vector<int> prev;
+    int classes = 0; // classes with two or more nodes
+    int twins = 0;   // nodes in them
+
+    // Neighborhoods are hashed as sums of random keys, so the classes are
+    // found in linear expected time; each candidate is then compared with
+    // the first node of its class
+    TwinClasses(const Graph& g) : next(g.n, -1), prev(g.n, -1) {
+        vector<uint64_t> key(g.n);
+        uint64_t z = 0x9e3779b97f4a7c15ULL;
+        for (int v = 0; v < g.n; v++) {
+            // splitmix64
+            z += 0x9e3779b97f4a7c15ULL;
+            uint64_t r = z;
+            r = (r ^ (r >> 30))*0xbf58476d1ce4e5b9ULL;
+            r = (r ^ (r >> 27))*0x94d049bb133111ebULL;
+            key[v] = r ^ (r >> 31);
+        }
+        vector<uint64_t> open(g.n, 0);
+        for (int v = 0; v < g.n; v++)
+            for (const int* w = g.begin(v); w != g.end(v); ++w) open[v] += key[*w];
+
+        vector<int> last(g.n, -1); // last node of the class v heads
+        for (int closed = 0; closed < 2; closed++) {
+            unordered_map<uint64_t, vector<int> > heads;
+            for (int v = 0; v < g.n; v++) {
+                if (prev[v] >= 0 or next[v] >= 0) continue;
+                uint64_t h = open[v] + (closed ? key[v] : 0) + uint64_t(g.degree(v))*0x2545f4914f6cdd1dULL;
+                vector<int>& list = heads[h];
+                int head = -1;
+                for (int u : list)
+                    if (same(g, u, v, closed)) head = u;
+                if (head < 0) {
+                    list.push_back(v);
+                    last[v] = v;
+                    continue;
+                }
+                next[last[head]] = v;
+                prev[v] = last[head];
+                last[head] = v;
+            }
+        }
+        for (int v = 0; v < g.n; v++) {
+            if (prev[v] >= 0) twins++;
+            else if (next[v] >= 0) {
+                twins++;
+                classes++;
+            }
+        }
+    }
+
+    // Ordering rows x[u] >= x[v] between consecutive twins left free
+    // (fixed[w] < 0); fixed twins are skipped, fixing is symmetric anyway
+    vector< pair<int,int> > orderPairs(const vector<int>& fixed) const {
+        vector< pair<int,int> > pairs;
+        for (int u = 0; u < int(next.size()); u++) {
+            if (prev[u] >= 0 or next[u] < 0) continue;
+            int last = -1;
+            for (int v = u; v >= 0; v = next[v]) {
+                if (fixed[v] >= 0) continue;
+                if (last >= 0) pairs.push_back(make_pair(last, v));
+                last = v;
+            }
+        }
+        return pairs;
+    }
+
+private:
+    // N(u) = N(v), or N[u] = N[v] if closed
+    static bool same(const Graph& g, int u, int v, bool closed) {
+        if (g.degree(u) != g.degree(v)) return false;
+        if (not closed) return equal(g.begin(u), g.end(u), g.begin(v));
+        // both lists sorted: compare them skipping v in N(u) and u in N(v)
+        if (not binary_search(g.begin(u), g.end(u), v)) return false;
+        const int* a = g.begin(u);
+        const int* b = g.begin(v);
+        while (true) {
+            if (a != g.end(u) and *a == v) ++a;
+            if (b != g.end(v) and *b == u) ++b;
+            if (a == g.end(u) or b == g.end(v)) return a == g.end(u) and b == g.end(v);
+            if (*a != *b) return false;
+            ++a;
+            ++b;
+        }
+    }
+};
+
+#endif
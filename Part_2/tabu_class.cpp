@@ -0,0 +1,224 @@
+#ifndef TABU_CLASS_CPP
+#define TABU_CLASS_CPP
+
+#include "pids_class.cpp"
+#include "swap_class.cpp"
+#include "Random.h"
+#include "Timer.h"
+#include <set>
+#include <queue>
+#include <tuple>
+#include <functional>
+#include <cstdint>
+
+//////////////////////////////////////////////////////////////
+//                  INCREMENTAL TABU SEARCH                 //
+//////////////////////////////////////////////////////////////
+
+// Tabu search over feasible solutions with add and delete moves.
+// A member can be deleted when it has no critical neighbor; a non-member
+// v is ranked by gain[v], the number of one-tight members that adding v
+// frees, then by its critical neighbors and then by the coverage it adds
+// (the score used by tabuSearch). The rankings only change near the last
+// move, so they are kept in ordered sets and refreshed from the nodes
+// the state and the one-tight index report as changed. Moves that are
+// tabu are filed in sets of their own and go back to the free sets when
+// their tenure expires (a queue of expiry iterations), so the best
+// admissible move is the front of a set. The best solution
+// is not copied: the moves done since the last improvement are kept in
+// a trail and undone at the end.
+struct TabuEngine {
+    PIDSState& s;
+    Random* rnd;
+    int64_t addTenure;
+    int64_t deleteTenure;
+
+    OneTightIndex index;
+    vector<double> weight;             // sum of 1/deg(x) over the neighbors of v
+    vector<int> gain;                  // one-tight members freed by adding v
+    vector<int> listSize;              // size of index.lists[x] already counted in gain
+    typedef pair<double,int> DeleteKey;
+    typedef tuple<int,int,double,int> AddKey;
+    set<DeleteKey> deletes;            // deletable members, largest weight first
+    set<AddKey> adds;                  // non-members, largest gain first
+    set<DeleteKey> tabuDeletes;        // the same while the move is tabu
+    set<AddKey> tabuAdds;
+    priority_queue< pair<int64_t,int>, vector< pair<int64_t,int> >, greater< pair<int64_t,int> > > expiries;
+    vector<int> keyCritical;           // critical count v is filed under, -1 if not filed
+    vector<int> keyGain;               // gain v is filed under
+    vector<char> keyTabu;              // v is filed in a tabu set
+    vector<int> dirty;
+    vector<int64_t> tabuAdd;
+    vector<int64_t> tabuDelete;
+    vector<int> touched;
+    vector<int> trail;
+    vector<int> seen;
+    int stamp = 0;
+
+    int64_t it = 0;
+    int bestSize;
+    size_t maxTrail;
+
+    // called with the new best size whenever it improves
+    function<void(int)> onImprove;
+
+    TabuEngine(PIDSState& state, Random* r, int64_t tenureAdd, int64_t tenureDelete)
+        : s(state), rnd(r), addTenure(tenureAdd), deleteTenure(tenureDelete), index(state) {
+        const Graph& g = *s.g;
+        weight.assign(g.n, 0.0);
+        gain.assign(g.n, 0);
+        listSize.assign(g.n, 0);
+        for (int v = 0; v < g.n; v++)
+            for (const int* x = g.begin(v); x != g.end(v); ++x) weight[v] += 1.0/g.degree(*x);
+        index.changed.clear();
+        for (int x = 0; x < g.n; x++) {
+            listSize[x] = index.lists[x].size();
+            for (const int* y = g.begin(x); y != g.end(x); ++y) gain[*y] += listSize[x];
+        }
+        keyCritical.assign(g.n, -1);
+        keyGain.assign(g.n, 0);
+        keyTabu.assign(g.n, 0);
+        tabuAdd.assign(g.n, 0);
+        tabuDelete.assign(g.n, 0);
+        seen.assign(g.n, 0);
+        for (int v = 0; v < g.n; v++) file(v);
+        bestSize = s.size();
+        maxTrail = 4*size_t(g.n) + (1 << 20);
+        s.touched = &touched;
+        s.trail = &trail;
+    }
+
+    ~TabuEngine() {
+        s.touched = nullptr;
+        s.trail = nullptr;
+    }
+
+    // One move, false if there is no move at all
+    bool step() {
+        // moves whose tenure is over are free again
+        while (not expiries.empty() and expiries.top().first <= it) {
+            int u = expiries.top().second;
+            expiries.pop();
+            if (keyCritical[u] >= 0) {
+                unfile(u);
+                file(u);
+            }
+        }
+
+        int v = -1;
+        bool del = false;
+        // aspiration: a delete that beats the best size is always allowed
+        bool aspiration = s.size() - 1 < bestSize;
+        if (not deletes.empty() or (aspiration and not tabuDeletes.empty())) {
+            v = firstDelete(aspiration);
+            del = true;
+        }
+        else if (not adds.empty()) v = get<3>(*adds.begin());
+        else if (not tabuDeletes.empty()) {
+            v = firstDelete(true);
+            del = true;
+        }
+        else if (not tabuAdds.empty()) v = get<3>(*tabuAdds.begin());
+        else return false;
+
+        if (del) {
+            s.remove(v);
+            tabuAdd[v] = it + addTenure + int64_t(rnd->next()*(addTenure/2 + 1));
+            expiries.push(make_pair(tabuAdd[v], v));
+        }
+        else {
+            s.add(v);
+            tabuDelete[v] = it + deleteTenure + int64_t(rnd->next()*(deleteTenure/2 + 1));
+            expiries.push(make_pair(tabuDelete[v], v));
+        }
+        sync();
+        it++;
+
+        if (s.size() < bestSize) {
+            bestSize = s.size();
+            trail.clear();
+            if (onImprove) onImprove(bestSize);
+        }
+        // restart from the best solution instead of growing the trail forever
+        else if (trail.size() > maxTrail) restoreBest();
+        return true;
+    }
+
+    // Search until the time limit or max_iterations, the state ends at the best solution
+    int run(Timer& timer, double time_limit, int64_t max_iterations = -1) {
+        for (int64_t k = 0; max_iterations < 0 or k < max_iterations; k++) {
+            if ((k & 255) == 0 and timer.elapsed_time(Timer::VIRTUAL) > time_limit) break;
+            if (not step()) break;
+        }
+        restoreBest();
+        return bestSize;
+    }
+
+    void restoreBest() {
+        s.rollback(0);
+        sync();
+    }
+
+private:
+    void sync() {
+        stamp++;
+        for (size_t k = 0; k < touched.size(); k++) {
+            index.refresh(touched[k]);
+            mark(touched[k]);
+        }
+        touched.clear();
+        for (int x : index.changed) {
+            int d = int(index.lists[x].size()) - listSize[x];
+            if (d == 0) continue;
+            listSize[x] += d;
+            for (const int* y = s.g->begin(x); y != s.g->end(x); ++y) {
+                gain[*y] += d;
+                mark(*y);
+            }
+        }
+        index.changed.clear();
+        for (int v : dirty) {
+            unfile(v);
+            file(v);
+        }
+        dirty.clear();
+    }
+
+    void mark(int v) {
+        if (seen[v] != stamp) {
+            seen[v] = stamp;
+            dirty.push_back(v);
+        }
+    }
+
+    // The best deletable member, tabu ones included if withTabu
+    int firstDelete(bool withTabu) const {
+        if (not withTabu or tabuDeletes.empty()) return deletes.begin()->second;
+        if (deletes.empty() or *tabuDeletes.begin() < *deletes.begin()) return tabuDeletes.begin()->second;
+        return deletes.begin()->second;
+    }
+
+    void file(int v) {
+        bool tabu;
+        if (s.in[v]) {
+            tabu = tabuDelete[v] > it;
+            if (s.critical[v] == 0) (tabu ? tabuDeletes : deletes).insert(DeleteKey(-weight[v], v));
+        }
+        else {
+            tabu = tabuAdd[v] > it;
+            (tabu ? tabuAdds : adds).insert(AddKey(-gain[v], -s.critical[v], weight[v], v));
+        }
+        keyCritical[v] = s.critical[v];
+        keyGain[v] = gain[v];
+        keyTabu[v] = tabu;
+    }
+
+    void unfile(int v) {
+        if (keyCritical[v] < 0) return;
+        if (keyCritical[v] == 0) (keyTabu[v] ? tabuDeletes : deletes).erase(DeleteKey(-weight[v], v));
+        (keyTabu[v] ? tabuAdds : adds).erase(AddKey(-keyGain[v], -keyCritical[v], weight[v], v));
+        keyCritical[v] = -1;
+    }
+};
+
+#endif
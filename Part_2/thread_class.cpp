@@ -0,0 +1,87 @@
+#ifndef THREAD_CLASS_CPP
+#define THREAD_CLASS_CPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////
+//                      THREAD POOL                         //
+//////////////////////////////////////////////////////////////
+
+// Fixed set of workers for parallel loops. run(n_tasks, job) calls
+// job(0) .. job(n_tasks-1) on the workers and on the calling thread and
+// returns once all of them are done, so it can be called every iteration
+// without paying for thread creation.
+struct ThreadPool {
+    int n_threads;
+    vector<thread> workers;
+    mutex m;
+    condition_variable start_cv;
+    condition_variable done_cv;
+    function<void(int)> job;
+    int n_tasks = 0;
+    atomic<int> next;
+    int running = 0;
+    long generation = 0;
+    bool stop = false;
+
+    ThreadPool(int threads) : n_threads(threads < 1 ? 1 : threads), next(0) {
+        for (int t = 1; t < n_threads; t++) workers.push_back(thread(&ThreadPool::loop, this));
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(m);
+            stop = true;
+        }
+        start_cv.notify_all();
+        for (thread& w : workers) w.join();
+    }
+
+    void run(int tasks, const function<void(int)>& f) {
+        if (n_threads == 1 or tasks <= 1) {
+            for (int t = 0; t < tasks; t++) f(t);
+            return;
+        }
+        {
+            lock_guard<mutex> lock(m);
+            job = f;
+            n_tasks = tasks;
+            next = 0;
+            running = n_threads;
+            generation++;
+        }
+        start_cv.notify_all();
+        work();
+        unique_lock<mutex> lock(m);
+        done_cv.wait(lock, [&] { return running == 0; });
+    }
+
+private:
+    void work() {
+        for (int t = next++; t < n_tasks; t = next++) job(t);
+        lock_guard<mutex> lock(m);
+        if (--running == 0) done_cv.notify_all();
+    }
+
+    void loop() {
+        long seen = 0;
+        while (true) {
+            {
+                unique_lock<mutex> lock(m);
+                start_cv.wait(lock, [&] { return stop or generation != seen; });
+                if (stop) return;
+                seen = generation;
+            }
+            work();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,218 @@
+/***************************************************************************
+    treewidth.cpp
+    (C) 2021 by C. Blum & M. Blesa
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "Timer.h"
+#include "../Part_1/greedy_class.cpp"
+#include "Random.h"
+#include "pids_class.cpp"
+#include "ccls_class.cpp"
+#include "treewidth_class.cpp"
+#include <vector>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string.h>
+#include <fstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include <limits>
+#include <iomanip>
+
+// global variables concerning the random number generator (in case needed)
+time_t t;
+Random* rnd;
+
+// Data structures for the problem data
+int n_of_nodes;
+int n_of_arcs;
+vector< unordered_set<int> > neighbors;
+Graph graph;
+
+// string for keeping the name of the input file
+string inputFile;
+
+// components whose min-degree decomposition is wider than <max_width>,
+// or whose DP tables get more than <max_states> entries, are left to the
+// heuristic: greedy followed by the configuration-checking search for
+// <time_limit> seconds
+int max_width = 10;
+long max_states = 1 << 21;
+double time_limit = 60.0;
+
+// number of applications
+int n_apps = 1;
+
+
+void read_parameters(int argc, char **argv) {
+
+    int iarg = 1;
+    while (iarg < argc) {
+        if (strcmp(argv[iarg],"-i") == 0) inputFile = argv[++iarg];
+        else if (strcmp(argv[iarg],"-t") == 0) time_limit = atof(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-n_apps") == 0) n_apps = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-width") == 0) max_width = atoi(argv[++iarg]);
+        else if (strcmp(argv[iarg],"-states") == 0) max_states = atol(argv[++iarg]);
+        iarg++;
+    }
+}
+
+
+// Main function
+
+int main( int argc, char **argv ) {
+
+    read_parameters(argc,argv);
+
+    // setting the output format for doubles to 2 decimals after the comma
+    std::cout << std::setprecision(2) << std::fixed;
+
+    rnd = new Random((unsigned) time(&t));
+    rnd->next();
+
+    // opening the corresponding input file and reading the problem data
+    ifstream indata;
+    indata.open(inputFile.c_str());
+    if (not indata) { // file couldn't be opened
+        cout << "Error: file could not be opened" << endl;
+    }
+
+    indata >> n_of_nodes;
+    indata >> n_of_arcs;
+    neighbors = vector< unordered_set<int> >(n_of_nodes);
+    int u, v;
+    while (indata >> u >> v) {
+        neighbors[u - 1].insert(v - 1);
+        neighbors[v - 1].insert(u - 1);
+    }
+    indata.close();
+    graph = buildGraph(neighbors);
+
+    // vectors for storing the result and the computation time
+    // obtained by the <n_apps> applications
+    vector<double> results(n_apps, std::numeric_limits<int>::max());
+    vector<double> times(n_apps, 0.0);
+
+    // main loop over all applications
+    for (int na = 0; na < n_apps; ++na) {
+
+        // the computation time starts now
+        Timer timer;
+
+        cout << "start application " << na + 1 << endl;
+
+        // exact DP on every component it can handle
+        vector< vector<int> > comps = components(graph);
+        TreeDP dp(graph, max_width, max_states);
+        vector<int> solution;
+        vector<int> rest;
+        int solved = 0;
+        int solvedNodes = 0;
+        int widest = 0;
+        long largest = 0;
+        int failedWidth = 0; // widest decomposition given up on
+        for (const vector<int>& comp : comps) {
+            vector<int> part;
+            if (dp.solve(comp, part)) {
+                solved++;
+                solvedNodes += comp.size();
+                widest = max(widest, dp.width);
+                largest = max(largest, dp.states);
+                solution.insert(solution.end(), part.begin(), part.end());
+            }
+            else {
+                failedWidth = max(failedWidth, dp.width);
+                rest.insert(rest.end(), comp.begin(), comp.end());
+            }
+        }
+        int exactPart = solution.size();
+        cout << "components " << comps.size() << "\tby DP " << solved << " (" << solvedNodes << " nodes)";
+        // without a component solved by DP there is no width to report
+        if (solved > 0) cout << "\twidth " << widest << "\tlargest table " << largest;
+        else cout << "\twidth -\tlargest table -";
+        if (not rest.empty()) cout << "\tgave up at width " << failedWidth;
+        cout << "\ttime " << timer.elapsed_time(Timer::VIRTUAL) << endl;
+        times[na] = timer.elapsed_time(Timer::VIRTUAL);
+        cout << "value " << exactPart << "\ttime " << times[na] << "\t(DP part)" << endl;
+
+        // the other components together go to the heuristic
+        if (not rest.empty()) {
+            vector<int> local(graph.n, -1);
+            for (int k = 0; k < int(rest.size()); k++) local[rest[k]] = k;
+            vector< unordered_set<int> > sub(rest.size());
+            for (int k = 0; k < int(rest.size()); k++)
+                for (const int* w = graph.begin(rest[k]); w != graph.end(rest[k]); ++w) sub[k].insert(local[*w]);
+            Graph subGraph = buildGraph(sub);
+            setNeighbor (sub);
+            unordered_set<int> greedySolution = greedy();
+            vector<int> start(greedySolution.begin(), greedySolution.end());
+            times[na] = timer.elapsed_time(Timer::VIRTUAL);
+            cout << "value " << exactPart + start.size() << "\ttime " << times[na] << endl;
+            CCLocalSearch search(subGraph, rnd);
+            search.load(start);
+            search.onImprove = [&](int k) {
+                times[na] = timer.elapsed_time(Timer::VIRTUAL);
+                cout << "value " << exactPart + k << "\ttime " << times[na] << endl;
+            };
+            search.run(timer, Timer::VIRTUAL, time_limit);
+            for (int k : search.best) solution.push_back(rest[k]);
+        }
+
+        results[na] = solution.size();
+        cout << "value " << solution.size() << "\ttime " << times[na] << endl;
+        if (rest.empty()) cout << "optimality proven" << endl;
+
+        unordered_set<int> set(solution.begin(), solution.end());
+        setNeighbor (neighbors);
+        if (not check_PIDS(set)) cout << "Error: solution is not a PIDS" << endl;
+        cout << "end application " << na + 1 << endl;
+    }
+
+    // calculating the average of the results and computation times,
+    // and their standard deviations, and write them to the screen
+    double r_mean = 0.0;
+    int r_best = std::numeric_limits<int>::max();
+    double t_mean = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        r_mean = r_mean + results[i];
+        if (int(results[i]) < r_best) r_best = int(results[i]);
+        t_mean = t_mean + times[i];
+    }
+    r_mean = r_mean/double(results.size());
+    t_mean = t_mean/double(times.size());
+    double rsd = 0.0;
+    double tsd = 0.0;
+    for (int i = 0; i < int(results.size()); i++) {
+        rsd = rsd + pow(results[i]-r_mean,2.0);
+        tsd = tsd + pow(times[i]-t_mean,2.0);
+    }
+    rsd = rsd/double(results.size());
+    if (rsd > 0.0) {
+        rsd = sqrt(rsd);
+    }
+    tsd = tsd/double(results.size());
+    if (tsd > 0.0) {
+        tsd = sqrt(tsd);
+    }
+    // printing statistical information
+    cout << r_best << "\t" << r_mean << "\t" << rsd << "\t";
+    cout << t_mean << "\t" << tsd << endl;
+}
@@ -0,0 +1,288 @@
+#ifndef TREEWIDTH_CLASS_CPP
+#define TREEWIDTH_CLASS_CPP
+
+#include "pids_class.cpp"
+#include <vector>
+#include <set>
+#include <unordered_set>
+#include <unordered_map>
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////
+//                       COMPONENTS                         //
+//////////////////////////////////////////////////////////////
+
+// Connected components of the graph, each as a list of nodes
+vector< vector<int> > components(const Graph& g) {
+    vector< vector<int> > comps;
+    vector<char> seen(g.n, 0);
+    for (int s = 0; s < g.n; s++) {
+        if (seen[s]) continue;
+        comps.push_back(vector<int>(1, s));
+        vector<int>& comp = comps.back();
+        seen[s] = 1;
+        for (size_t k = 0; k < comp.size(); k++) {
+            for (const int* w = g.begin(comp[k]); w != g.end(comp[k]); ++w) {
+                if (seen[*w]) continue;
+                seen[*w] = 1;
+                comp.push_back(*w);
+            }
+        }
+    }
+    return comps;
+}
+
+
+//////////////////////////////////////////////////////////////
+//                  TREE DECOMPOSITION DP                   //
+//////////////////////////////////////////////////////////////
+
+// Exact solver for one component through a tree decomposition built by
+// min-degree elimination: the bag of node c is c and its neighbors when
+// it is eliminated (higher[c]), and its parent is the first of them to
+// be eliminated. The DP runs in elimination order. The table of c holds,
+// for every node u of higher[c], whether u is a member and how many
+// member neighbors it has through the edges seen so far, capped at
+// need[u]; an edge is seen when its first end is forgotten. To build it,
+// all member patterns of the bag are joined with the tables of the
+// children, adding up the counts; then c is forgotten: its edges to the
+// bag are counted, its own count has to reach need[c], and a member c
+// adds one to the cost. Back pointers rebuild the solution from the root.
+// solve() gives up when the width passes maxWidth or a table gets more
+// than maxStates entries.
+struct TreeDP {
+    const Graph& g;
+    int maxWidth;
+    long maxStates;
+
+    int width = 0;    // width of the last decomposition built
+    long states = 0;  // largest table of the last solve
+
+    TreeDP(const Graph& graph, int max_width, long max_states)
+        : g(graph), maxWidth(max_width), maxStates(max_states) {}
+
+    // Minimum PIDS restricted to the component comp, or false
+    bool solve(const vector<int>& comp, vector<int>& solution) {
+        int k = comp.size();
+        width = 0;
+        states = 0;
+        if (k == 1) return true; // isolated node: need 0
+        unordered_map<int,int> id;
+        for (int a = 0; a < k; a++) id[comp[a]] = a;
+        if (not eliminate(comp, id)) return false;
+
+        // children of every node, and the DP bottom up
+        vector< vector<int> > kids(k);
+        int root = -1;
+        for (int c : order) {
+            if (higher[c].empty()) root = c;
+            else {
+                int parent = higher[c][0];
+                for (int u : higher[c])
+                    if (pos[u] < pos[parent]) parent = u;
+                kids[parent].push_back(c);
+            }
+        }
+        tables.assign(k, Table());
+        stageBack.assign(k, vector< vector< pair<int,int> > >());
+        forgetBack.assign(k, vector<int>());
+        forgetMember.assign(k, vector<char>());
+        for (int c : order) {
+            if (not process(comp, c, kids[c])) return false;
+            for (int kid : kids[c]) tables[kid] = Table();
+        }
+
+        // root table: a single state over no node
+        if (tables[root].cost.empty()) return false;
+        vector< pair<int,int> > stack(1, make_pair(root, 0));
+        while (not stack.empty()) {
+            int c = stack.back().first;
+            int e = stack.back().second;
+            stack.pop_back();
+            if (forgetMember[c][e]) solution.push_back(comp[c]);
+            int j = forgetBack[c][e];
+            for (int s = int(kids[c].size()) - 1; s >= 0; s--) {
+                stack.push_back(make_pair(kids[c][s], stageBack[c][s][j].second));
+                j = stageBack[c][s][j].first;
+            }
+        }
+        return true;
+    }
+
+private:
+    // DP table over the nodes vars: entry e has value x + 2 count for
+    // node vars[i] at state[e*vars.size() + i]
+    struct Table {
+        vector<int> vars;
+        vector<int> state;
+        vector<int> cost;
+        int size() const { return cost.size(); }
+    };
+
+    struct StateHash {
+        size_t operator()(const vector<int>& s) const {
+            size_t h = s.size();
+            for (int v : s) h = h*1000003u ^ size_t(v);
+            return h;
+        }
+    };
+
+    vector<int> order;
+    vector<int> pos;
+    vector< vector<int> > higher;
+    vector<Table> tables;
+    vector< vector< vector< pair<int,int> > > > stageBack; // per child: (previous entry, child entry)
+    vector< vector<int> > forgetBack;
+    vector< vector<char> > forgetMember;
+
+    // Min-degree elimination order with its bags, false if the width passes maxWidth
+    bool eliminate(const vector<int>& comp, unordered_map<int,int>& id) {
+        int k = comp.size();
+        vector< unordered_set<int> > adj(k);
+        for (int a = 0; a < k; a++)
+            for (const int* w = g.begin(comp[a]); w != g.end(comp[a]); ++w) adj[a].insert(id[*w]);
+        set< pair<int,int> > queue;
+        for (int a = 0; a < k; a++) queue.insert(make_pair(adj[a].size(), a));
+        order.clear();
+        pos.assign(k, -1);
+        higher.assign(k, vector<int>());
+        while (not queue.empty()) {
+            int c = queue.begin()->second;
+            queue.erase(queue.begin());
+            if (int(adj[c].size()) > maxWidth) {
+                width = adj[c].size();
+                return false;
+            }
+            width = max(width, int(adj[c].size()));
+            pos[c] = order.size();
+            order.push_back(c);
+            higher[c].assign(adj[c].begin(), adj[c].end());
+            sort(higher[c].begin(), higher[c].end());
+            for (int u : higher[c]) {
+                queue.erase(make_pair(adj[u].size(), u));
+                adj[u].erase(c);
+            }
+            // the neighbors of c become a clique
+            for (int u : higher[c])
+                for (int v : higher[c])
+                    if (u < v and adj[u].insert(v).second) adj[v].insert(u);
+            for (int u : higher[c]) queue.insert(make_pair(adj[u].size(), u));
+            adj[c].clear();
+        }
+        return true;
+    }
+
+    bool original(int u, int v, const vector<int>& comp) const {
+        return binary_search(g.begin(comp[u]), g.end(comp[u]), comp[v]);
+    }
+
+    bool process(const vector<int>& comp, int c, const vector<int>& kids) {
+        // the bag: c first, then higher[c]
+        vector<int> bag(1, c);
+        bag.insert(bag.end(), higher[c].begin(), higher[c].end());
+        int b = bag.size();
+        vector<int> cap(b);
+        for (int i = 0; i < b; i++) cap[i] = g.need[comp[bag[i]]];
+
+        // every member pattern of the bag, nothing counted yet
+        vector<int> state;
+        vector<int> cost;
+        for (int mask = 0; mask < (1 << b); mask++) {
+            for (int i = 0; i < b; i++) state.push_back((mask >> i) & 1);
+            cost.push_back(0);
+        }
+
+        vector<int> st(b);
+        for (int kid : kids) {
+            const Table& t = tables[kid];
+            int kv = t.vars.size();
+            vector<int> at(kv);
+            for (int i = 0; i < kv; i++) at[i] = find(bag.begin(), bag.end(), t.vars[i]) - bag.begin();
+            unordered_map<int, vector<int> > byMask;
+            for (int e = 0; e < t.size(); e++) {
+                int mask = 0;
+                for (int i = 0; i < kv; i++) mask |= (t.state[e*kv + i] & 1) << i;
+                byMask[mask].push_back(e);
+            }
+            vector<int> nextState;
+            vector<int> nextCost;
+            vector< pair<int,int> > back;
+            unordered_map<vector<int>, int, StateHash> index;
+            int n_entries = cost.size();
+            for (int j = 0; j < n_entries; j++) {
+                int mask = 0;
+                for (int i = 0; i < kv; i++) mask |= (state[j*b + at[i]] & 1) << i;
+                auto found = byMask.find(mask);
+                if (found == byMask.end()) continue;
+                for (int e : found->second) {
+                    for (int i = 0; i < b; i++) st[i] = state[j*b + i];
+                    for (int i = 0; i < kv; i++) {
+                        int p = at[i];
+                        int count = min(cap[p], st[p]/2 + t.state[e*kv + i]/2);
+                        st[p] = (st[p] & 1) + 2*count;
+                    }
+                    int value = cost[j] + t.cost[e];
+                    auto slot = index.find(st);
+                    if (slot == index.end()) {
+                        if (long(nextCost.size()) >= maxStates) return false;
+                        index[st] = nextCost.size();
+                        nextState.insert(nextState.end(), st.begin(), st.end());
+                        nextCost.push_back(value);
+                        back.push_back(make_pair(j, e));
+                    }
+                    else if (value < nextCost[slot->second]) {
+                        nextCost[slot->second] = value;
+                        back[slot->second] = make_pair(j, e);
+                    }
+                }
+            }
+            states = max(states, long(nextCost.size()));
+            if (long(nextCost.size()) > maxStates) return false;
+            state.swap(nextState);
+            cost.swap(nextCost);
+            stageBack[c].push_back(back);
+        }
+
+        // forget c
+        vector<char> edge(b, 0);
+        for (int i = 1; i < b; i++) edge[i] = original(c, bag[i], comp);
+        Table& t = tables[c];
+        t.vars = higher[c];
+        unordered_map<vector<int>, int, StateHash> index;
+        vector<int> key(b - 1);
+        int n_entries = cost.size();
+        for (int j = 0; j < n_entries; j++) {
+            for (int i = 0; i < b; i++) st[i] = state[j*b + i];
+            int xc = st[0] & 1;
+            int count = st[0]/2;
+            for (int i = 1; i < b; i++) {
+                if (not edge[i]) continue;
+                if (st[i] & 1) count++;
+                if (xc) st[i] = (st[i] & 1) + 2*min(cap[i], st[i]/2 + 1);
+            }
+            if (count < cap[0]) continue;
+            for (int i = 1; i < b; i++) key[i - 1] = st[i];
+            int value = cost[j] + xc;
+            auto slot = index.find(key);
+            if (slot == index.end()) {
+                index[key] = t.cost.size();
+                t.state.insert(t.state.end(), key.begin(), key.end());
+                t.cost.push_back(value);
+                forgetBack[c].push_back(j);
+                forgetMember[c].push_back(xc);
+            }
+            else if (value < t.cost[slot->second]) {
+                t.cost[slot->second] = value;
+                forgetBack[c][slot->second] = j;
+                forgetMember[c][slot->second] = xc;
+            }
+        }
+        states = max(states, long(t.size()));
+        return long(t.size()) <= maxStates;
+    }
+};
+
+#endif
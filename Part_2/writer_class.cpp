@@ -0,0 +1,230 @@
+#ifndef WRITER_CLASS_CPP
+#define WRITER_CLASS_CPP
+
+#include "pids_class.cpp"
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdarg>
+#include <zlib.h>
+
+using namespace std;
+
+//////////////////////////////////////////////////////////////
+//                      MODEL STREAM                        //
+//////////////////////////////////////////////////////////////
+
+// Text output to a plain file, or gzipped if the name ends in ".gz"
+struct ModelStream {
+    FILE* file = nullptr;
+    gzFile gz = nullptr;
+
+    bool open(const string& name) {
+        if (name.size() > 3 and name.compare(name.size() - 3, 3, ".gz") == 0) gz = gzopen(name.c_str(), "wb");
+        else file = fopen(name.c_str(), "w");
+        return file or gz;
+    }
+
+    void print(const char* format, ...) {
+        char buffer[256];
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        len = min(len, int(sizeof(buffer)) - 1);
+        if (gz) gzwrite(gz, buffer, len);
+        else fwrite(buffer, 1, len, file);
+    }
+
+    void close() {
+        if (gz) gzclose(gz);
+        if (file) fclose(file);
+        gz = nullptr;
+        file = nullptr;
+    }
+};
+
+
+//////////////////////////////////////////////////////////////
+//                      MODEL WRITER                        //
+//////////////////////////////////////////////////////////////
+
+// Writes the MPIDS ILP of a graph straight from the adjacency, without
+// building the model: one binary x<id> per free node, where id is the
+// 1-based node id of the input file, and one row c<id> per node whose
+// threshold is not met by the nodes fixed to 1. fixed[v] is 0 or 1 for
+// the nodes removed by a reduction, -1 for the free ones. Besides the
+// graph it keeps one residual threshold per node
+struct ModelWriter {
+    const Graph& g;
+    const vector<int>& fixed;
+    vector<int> residual; // need[v] minus the neighbors of v fixed to 1
+    int offset = 0;       // nodes fixed to 1, to add to the objective
+    int n_vars = 0;
+    int n_rows = 0;
+
+    // optional symmetry rows x[u] >= x[v], named s1, s2, ...
+    vector< pair<int,int> > order;
+
+    ModelWriter(const Graph& graph, const vector<int>& fix) : g(graph), fixed(fix), residual(graph.need) {
+        for (int v = 0; v < g.n; v++) {
+            if (fixed[v] < 0) n_vars++;
+            if (fixed[v] != 1) continue;
+            offset++;
+            for (const int* i = g.begin(v); i != g.end(v); ++i) residual[*i]--;
+        }
+        for (int v = 0; v < g.n; v++)
+            if (residual[v] > 0) n_rows++;
+    }
+
+    void setOrder(const vector< pair<int,int> >& pairs) {
+        n_rows += int(pairs.size()) - int(order.size());
+        order = pairs;
+    }
+
+    // CPLEX LP format, at most 8 terms per line
+    void writeLP(ModelStream& out, const string& name) const {
+        out.print("\\ MPIDS model of %s\n", name.c_str());
+        out.print("\\ %d variables, %d rows, %d nodes fixed to 1 (add them to the objective)\n",
+                  n_vars, n_rows, offset);
+        out.print("Minimize\n obj:");
+        int terms = 0;
+        for (int v = 0; v < g.n; v++) {
+            if (fixed[v] >= 0) continue;
+            out.print(terms == 0 ? " x%d" : " + x%d", v + 1);
+            if (++terms % 8 == 0) out.print("\n");
+        }
+        out.print("\nSubject To\n");
+        for (int i = 0; i < g.n; i++) {
+            if (residual[i] <= 0) continue;
+            out.print(" c%d:", i + 1);
+            terms = 0;
+            for (const int* v = g.begin(i); v != g.end(i); ++v) {
+                if (fixed[*v] >= 0) continue;
+                out.print(terms == 0 ? " x%d" : " + x%d", *v + 1);
+                if (++terms % 8 == 0) out.print("\n");
+            }
+            out.print(" >= %d\n", residual[i]);
+        }
+        for (size_t k = 0; k < order.size(); k++)
+            out.print(" s%d: x%d - x%d >= 0\n", int(k) + 1, order[k].first + 1, order[k].second + 1);
+        out.print("Binaries\n");
+        terms = 0;
+        for (int v = 0; v < g.n; v++) {
+            if (fixed[v] >= 0) continue;
+            out.print(" x%d", v + 1);
+            if (++terms % 8 == 0) out.print("\n");
+        }
+        out.print("\nEnd\n");
+    }
+
+    // Free MPS format. The columns are written one by one: as the graph
+    // is undirected, the rows of x<v> are those of the neighbors of v
+    void writeMPS(ModelStream& out, const string& name) const {
+        out.print("* MPIDS model of %s\n", name.c_str());
+        out.print("* %d variables, %d rows, %d nodes fixed to 1 (add them to the objective)\n",
+                  n_vars, n_rows, offset);
+        out.print("NAME MPIDS\nROWS\n N obj\n");
+        for (int i = 0; i < g.n; i++)
+            if (residual[i] > 0) out.print(" G c%d\n", i + 1);
+        vector<int> up(g.n, -1);   // symmetry row where v has coefficient 1
+        vector<int> down(g.n, -1); // and where it has -1
+        for (size_t k = 0; k < order.size(); k++) {
+            out.print(" G s%d\n", int(k) + 1);
+            up[order[k].first] = k;
+            down[order[k].second] = k;
+        }
+        out.print("COLUMNS\n MARKER 'MARKER' 'INTORG'\n");
+        for (int v = 0; v < g.n; v++) {
+            if (fixed[v] >= 0) continue;
+            out.print(" x%d obj 1\n", v + 1);
+            for (const int* i = g.begin(v); i != g.end(v); ++i)
+                if (residual[*i] > 0) out.print(" x%d c%d 1\n", v + 1, *i + 1);
+            if (up[v] >= 0) out.print(" x%d s%d 1\n", v + 1, up[v] + 1);
+            if (down[v] >= 0) out.print(" x%d s%d -1\n", v + 1, down[v] + 1);
+        }
+        out.print(" MARKER 'MARKER' 'INTEND'\nRHS\n");
+        for (int i = 0; i < g.n; i++)
+            if (residual[i] > 0) out.print(" rhs c%d %d\n", i + 1, residual[i]);
+        out.print("BOUNDS\n");
+        for (int v = 0; v < g.n; v++)
+            if (fixed[v] < 0) out.print(" BV bnd x%d\n", v + 1);
+        out.print("ENDATA\n");
+    }
+
+    // OPB pseudo-Boolean format: the coverage rows are cardinality
+    // constraints and the objective is the sum of the free variables
+    void writeOPB(ModelStream& out, const string& name) const {
+        out.print("* #variable= %d #constraint= %d\n", g.n, n_rows);
+        out.print("* MPIDS model of %s\n", name.c_str());
+        out.print("* %d nodes fixed to 1 (add them to the objective)\n", offset);
+        out.print("min:");
+        for (int v = 0; v < g.n; v++)
+            if (fixed[v] < 0) out.print(" +1 x%d", v + 1);
+        out.print(" ;\n");
+        for (int i = 0; i < g.n; i++) {
+            if (residual[i] <= 0) continue;
+            for (const int* v = g.begin(i); v != g.end(i); ++v)
+                if (fixed[*v] < 0) out.print("+1 x%d ", *v + 1);
+            out.print(">= %d ;\n", residual[i]);
+        }
+        for (const auto& p : order) out.print("+1 x%d -1 x%d >= 0 ;\n", p.first + 1, p.second + 1);
+    }
+
+    // Weighted MaxSAT in the WCNF format without header: a soft unit
+    // clause -x per free node and the coverage rows as hard clauses (a
+    // symmetry row is the binary clause x[u] or not x[v]). At
+    // least r of the l free neighbors of a node is at most l - r of their
+    // negations, encoded with a sequential counter over (l-1)(l-r) new
+    // variables numbered after the nodes. Quadratic in the degree, so
+    // meant for graphs without hubs
+    void writeWCNF(ModelStream& out, const string& name) const {
+        out.print("c MPIDS model of %s\n", name.c_str());
+        out.print("c %d nodes fixed to 1 (add them to the cost)\n", offset);
+        for (int v = 0; v < g.n; v++)
+            if (fixed[v] < 0) out.print("1 -%d 0\n", v + 1);
+        int next = g.n + 1;
+        vector<int> lits;
+        for (int i = 0; i < g.n; i++) {
+            if (residual[i] <= 0) continue;
+            lits.clear();
+            for (const int* v = g.begin(i); v != g.end(i); ++v)
+                if (fixed[*v] < 0) lits.push_back(*v + 1);
+            int l = lits.size();
+            int k = l - residual[i];
+            if (k < 0) out.print("h 0\n");
+            if (k == 0)
+                for (int a : lits) out.print("h %d 0\n", a);
+            if (k <= 0 or l == 1) continue;
+            // s(p, q): at least q + 1 of the first p + 1 negations are true
+            auto s = [&](int p, int q) { return next + p*k + q; };
+            out.print("h %d %d 0\n", lits[0], s(0, 0));
+            for (int q = 1; q < k; q++) out.print("h -%d 0\n", s(0, q));
+            for (int p = 1; p < l - 1; p++) {
+                out.print("h %d %d 0\n", lits[p], s(p, 0));
+                out.print("h -%d %d 0\n", s(p - 1, 0), s(p, 0));
+                for (int q = 1; q < k; q++) {
+                    out.print("h %d -%d %d 0\n", lits[p], s(p - 1, q - 1), s(p, q));
+                    out.print("h -%d %d 0\n", s(p - 1, q), s(p, q));
+                }
+                out.print("h %d -%d 0\n", lits[p], s(p - 1, k - 1));
+            }
+            out.print("h %d -%d 0\n", lits[l - 1], s(l - 2, k - 1));
+            next += (l - 1)*k;
+        }
+        for (const auto& p : order) out.print("h %d -%d 0\n", p.first + 1, p.second + 1);
+    }
+
+    // Mapping back to the input: every column with its node id, then the
+    // nodes removed by the reductions with their value
+    void writeMapping(ModelStream& out) const {
+        out.print("# offset %d\n# column node\n", offset);
+        for (int v = 0; v < g.n; v++)
+            if (fixed[v] < 0) out.print("x%d %d\n", v + 1, v + 1);
+        out.print("# fixed node value\n");
+        for (int v = 0; v < g.n; v++)
+            if (fixed[v] >= 0) out.print("fixed %d %d\n", v + 1, fixed[v]);
+    }
+};
+
+#endif
@@ -5,6 +5,20 @@ echo Posibilities of names of files:
 echo - greedy
 echo - local_search
 echo - metaheuristic
+echo - memetic
+echo - ils
+echo - aco
+echo - lns
+echo - cmsa
+echo - mip_mpids
+echo - exact
+echo - lagrangian
+echo - pbls
+echo - ccls
+echo - treewidth
+echo - multilevel
+echo - partition
+echo - portfolio
 echo - cplex
 echo ----------------------------
 echo